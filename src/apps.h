@@ -0,0 +1,22 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Multi-Application Image Table (make multi, see utils/multiapp.py)
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// 每个程序的 main 被编译为 __app_<name>_main，.data/.bss 由链接脚本单独成段；
+// shadow 为上电时 .data 初始值的备份（NOLOAD），每次启动前拷回 .data 并清零 .bss
+typedef struct {
+    const char *name;
+    int       (*main)(void);
+    char       *data_start;
+    char       *data_end;
+    char       *bss_start;
+    char       *bss_end;
+    char       *shadow;
+} app_t;
+
+// 由 utils/multiapp.py 生成的 build/multi/apps.c 定义
+extern const app_t app_table[];
+extern const int app_count;
@@ -0,0 +1,51 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Benchmark Timing and Reporting Helpers
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "bench.h"
+#include "uart.h"
+#include "timer.h"
+#include <stdint.h>
+
+void bench_header(const char *program)
+{
+    init_timer();
+
+    print_uart("\n");
+    print_uart("=========================================\n");
+    printf_uart("      %s\n", program);
+    print_uart("=========================================\n");
+    printf_uart("Core clock: %u cycles/us (calibrated against mtime)\n\n", timer_cycles_per_us());
+}
+
+void bench_print_milli(uint64_t value)
+{
+    print_uart_dec_64b(value / 1000);
+    print_uart_char('.');
+    uint32_t frac = value % 1000;
+    print_uart_char('0' + frac / 100);
+    print_uart_char('0' + (frac / 10) % 10);
+    print_uart_char('0' + frac % 10);
+}
+
+void bench_report(const char *name, const bench_t *b, uint32_t iterations, int errors)
+{
+    printf_uart("[%s] cycles: %lu, instret: %lu, CPI: ", name, b->cycles, b->instret);
+    bench_print_milli(b->instret ? b->cycles * 1000 / b->instret : 0);
+    if (iterations > 0)
+        printf_uart(", cycles/iter: %lu", b->cycles / iterations);
+    printf_uart(", %s\n", errors == 0 ? "PASS" : "FAIL");
+    result_emit(name, b->cycles, b->instret, 0, errors);
+}
+
+// xorshift32，所有工作负载共用，保证输入数据可复现
+uint32_t bench_rand(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
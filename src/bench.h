@@ -0,0 +1,41 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Benchmark Timing and Reporting Helpers
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include "csr.h"
+#include "uart.h"
+#include "mem.h"
+#include "result.h"
+
+typedef struct {
+    uint64_t cycle0;
+    uint64_t instret0;
+    uint64_t cycles;
+    uint64_t instret;
+} bench_t;
+
+static inline void bench_start(bench_t *b)
+{
+    b->instret0 = read_minstret();
+    b->cycle0 = read_mcycle();
+}
+
+static inline void bench_stop(bench_t *b)
+{
+    b->cycles = read_mcycle() - b->cycle0;
+    b->instret = read_minstret() - b->instret0;
+}
+
+void bench_header(const char *program);
+
+// 输出一项结果：周期数、指令数、CPI、每次迭代周期数以及自检结果，同时输出一条 @RESULT
+void bench_report(const char *name, const bench_t *b, uint32_t iterations, int errors);
+
+// 以三位小数输出 value / 1000
+void bench_print_milli(uint64_t value);
+
+uint32_t bench_rand(uint32_t *state);
@@ -0,0 +1,137 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Data Cache Control (fence, flush/invalidate by range, uncached access)
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "cache.h"
+#include "csr.h"
+#include "sections.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef CACHE_ZICBOM
+// 置换用缓冲区，2 倍容量保证组相联缓存的每一路都被替换；放在 .dram_bss 不占镜像
+static uint64_t cache_evict_buf[2 * CACHE_DCACHE_BYTES / 8] __dram_bss __attribute__((aligned(64)));
+#endif
+
+#ifdef CACHE_ZICBOM
+// cbo.flush / cbo.inval：MISC-MEM，funct3=2，立即数为操作码
+#define CBO_FLUSH(p) __asm__ volatile (".insn i 0x0f, 2, x0, %0, 2" :: "r"(p) : "memory")
+#define CBO_INVAL(p) __asm__ volatile (".insn i 0x0f, 2, x0, %0, 0" :: "r"(p) : "memory")
+#endif
+
+void cache_flush_all(void)
+{
+    cache_fence();
+#ifndef CACHE_ZICBOM
+    // 每个缓存行读一次，volatile 防止被优化掉
+    volatile const uint64_t *p = cache_evict_buf;
+    const size_t step = CACHE_LINE_BYTES / 8 ? CACHE_LINE_BYTES / 8 : 1;
+    for (size_t i = 0; i < sizeof(cache_evict_buf) / 8; i += step)
+        (void)p[i];
+    cache_fence();
+#endif
+}
+
+void cache_flush_range(const void *addr, size_t len)
+{
+#ifdef CACHE_ZICBOM
+    uintptr_t p = (uintptr_t)addr & ~(uintptr_t)(CACHE_LINE_BYTES - 1);
+    uintptr_t end = (uintptr_t)addr + len;
+    cache_fence();
+    for (; p < end; p += CACHE_LINE_BYTES)
+        CBO_FLUSH(p);
+    cache_fence();
+#else
+    // 范围不小于缓存容量时置换一遍和逐行处理效果相同
+    (void)addr;
+    (void)len;
+    cache_flush_all();
+#endif
+}
+
+void cache_invalidate_range(const void *addr, size_t len)
+{
+#ifdef CACHE_ZICBOM
+    uintptr_t p = (uintptr_t)addr & ~(uintptr_t)(CACHE_LINE_BYTES - 1);
+    uintptr_t end = (uintptr_t)addr + len;
+    cache_fence();
+    for (; p < end; p += CACHE_LINE_BYTES)
+        CBO_INVAL(p);
+    cache_fence();
+#else
+    cache_flush_range(addr, len);
+#endif
+}
+
+int cache_uncached_available(void)
+{
+#if defined(CACHE_UNCACHED_OFFSET) || defined(CACHE_CVA6_CSR)
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+void *cache_uncached(void *addr)
+{
+#ifdef CACHE_UNCACHED_OFFSET
+    return (void *)((uintptr_t)addr + CACHE_UNCACHED_OFFSET);
+#else
+    return addr;
+#endif
+}
+
+void cache_uncached_begin(void)
+{
+#if !defined(CACHE_UNCACHED_OFFSET) && defined(CACHE_CVA6_CSR)
+    // 关闭前先写回，避免关闭期间读到内存中的旧数据
+    cache_flush_all();
+    // CVA6 数据缓存使能 CSR（bit 0），0x7C0 为指令缓存
+    clear_csr(0x7C1, 1);
+    cache_fence();
+#endif
+}
+
+void cache_uncached_end(void)
+{
+#if !defined(CACHE_UNCACHED_OFFSET) && defined(CACHE_CVA6_CSR)
+    cache_fence();
+    set_csr(0x7C1, 1);
+#endif
+}
+
+void *cache_prepare(void *addr, size_t len, cache_mode_t mode)
+{
+    switch (mode) {
+    case CACHE_MODE_COLD:
+        cache_flush_range(addr, len);
+        return addr;
+    case CACHE_MODE_UNCACHED:
+        // 别名访问的是同一块内存，缓存中的脏数据必须先写回
+        cache_flush_range(addr, len);
+        cache_uncached_begin();
+        return cache_uncached(addr);
+    default:
+        cache_fence();
+        return addr;
+    }
+}
+
+const char *cache_mode_name(cache_mode_t mode)
+{
+    switch (mode) {
+    case CACHE_MODE_COLD:     return "cold";
+    case CACHE_MODE_UNCACHED: return "uncached";
+    default:                  return "warm";
+    }
+}
+
+const char *cache_impl_name(void)
+{
+#ifdef CACHE_ZICBOM
+    return "zicbom";
+#else
+    return "evict";
+#endif
+}
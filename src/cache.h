@@ -0,0 +1,69 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Data Cache Control (fence, flush/invalidate by range, uncached access)
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 数据缓存行大小与容量，CVA6 默认 16B 行、32KB；按实际内核用 -D 修改
+#ifndef CACHE_LINE_BYTES
+#define CACHE_LINE_BYTES 16
+#endif
+
+#ifndef CACHE_DCACHE_BYTES
+#define CACHE_DCACHE_BYTES (32 * 1024)
+#endif
+
+// 按地址范围维护缓存的实现：
+//   -DCACHE_ZICBOM   : cbo.flush / cbo.inval（内核须实现 Zicbom，否则是非法指令）
+//   默认             : 读一块 2 倍缓存容量的缓冲区把整个数据缓存置换出去
+// -DCACHE_CVA6_CSR 时可通过 CVA6 的自定义 CSR 0x7C1 关闭数据缓存，作为非缓存访问方式
+// -DCACHE_UNCACHED_OFFSET=... 为 SoC 提供的非缓存别名地址相对原地址的偏移
+
+typedef enum {
+    CACHE_MODE_WARM = 0,    // 不做处理，可能命中缓存
+    CACHE_MODE_COLD,        // 访问前把对应范围写回并移出缓存
+    CACHE_MODE_UNCACHED     // 通过非缓存别名或关闭数据缓存访问
+} cache_mode_t;
+
+// 所有之前的访存对之后的访存可见
+static inline void cache_fence(void)
+{
+    __asm__ volatile ("fence rw, rw" ::: "memory");
+}
+
+// 指令缓存与之前写入的指令同步（基础 -march 不含 Zifencei，直接给出编码）
+static inline void cache_fence_i(void)
+{
+    __asm__ volatile (".insn i 0x0f, 1, x0, x0, 0" ::: "memory");
+}
+
+// 把 [addr, addr+len) 中的脏数据写回内存，并使之后的读取不命中缓存
+void cache_flush_range(const void *addr, size_t len);
+
+// 丢弃 [addr, addr+len) 的缓存内容（没有 Zicbom 时与 flush 相同，会先写回）
+void cache_invalidate_range(const void *addr, size_t len);
+
+// 写回并移出整个数据缓存
+void cache_flush_all(void);
+
+// 是否有非缓存访问方式（别名地址或可关闭的数据缓存）
+int cache_uncached_available(void);
+
+// 非缓存别名地址；没有别名时返回原地址，需配合 cache_uncached_begin/end
+void *cache_uncached(void *addr);
+
+// 没有别名地址时在这两个调用之间关闭数据缓存（CVA6），否则什么都不做
+void cache_uncached_begin(void);
+void cache_uncached_end(void);
+
+// 按模式在访问 [addr, addr+len) 之前准备缓存状态，返回实际访问用的地址；
+// CACHE_MODE_UNCACHED 访问结束后须调用 cache_uncached_end()
+void *cache_prepare(void *addr, size_t len, cache_mode_t mode);
+
+const char *cache_mode_name(cache_mode_t mode);
+
+const char *cache_impl_name(void);
@@ -0,0 +1,21 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Console Backends (16550 / Altera JTAG UART / RAM ring / semihosting)
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "console.h"
+#include <stdint.h>
+
+#ifdef CONSOLE_RING
+// 放在 .data 中，magic/size 随镜像一起加载，调试器可按符号或扫描 magic 找到
+console_ring_t console_ring = {
+    .magic   = CONSOLE_RING_MAGIC,
+    .size    = CONSOLE_RING_SIZE,
+    .rx_size = CONSOLE_RING_RX_SIZE,
+};
+#endif
+
+const char *console_name(void)
+{
+    return CONSOLE_NAME;
+}
@@ -0,0 +1,267 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Console Backends (16550 / Altera JTAG UART / RAM ring / semihosting)
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// 编译时选择后端（make CONSOLE=16550|jtag|ring|semihost）：
+//   CONSOLE_16550    : NS16550 兼容 UART（默认）
+//   CONSOLE_JTAG     : Altera/Intel JTAG UART（PLAT_AGILEX 时默认）
+//   CONSOLE_RING     : 内存环形缓冲区，调试器用 console_ring 符号整块读取
+//   CONSOLE_SEMIHOST : RISC-V 半主机调用，由仿真器或调试器输出
+// 所有后端都是 static inline，print_uart* 直接内联对应的寄存器访问，没有间接调用
+
+#include <stdint.h>
+
+// make UART_TELEMETRY=1：16550 每次读 LSR 都记录错误位，jtag 记录发送 FIFO 占用，
+// ring 记录接收缓冲区占用
+#ifdef UART_TELEMETRY
+#include "uart_telemetry.h"
+#endif
+
+#if defined(PLAT_AGILEX) && !defined(CONSOLE_16550) && !defined(CONSOLE_RING) && !defined(CONSOLE_SEMIHOST)
+#define CONSOLE_JTAG
+#endif
+
+#if !defined(CONSOLE_16550) && !defined(CONSOLE_JTAG) && !defined(CONSOLE_RING) && !defined(CONSOLE_SEMIHOST)
+#define CONSOLE_16550
+#endif
+
+#if defined(CONSOLE_16550) + defined(CONSOLE_JTAG) + defined(CONSOLE_RING) + defined(CONSOLE_SEMIHOST) != 1
+#error "select exactly one console backend"
+#endif
+
+// UART / JTAG UART 的寄存器基地址
+#ifndef CONSOLE_BASE
+#define CONSOLE_BASE 0x10000000
+#endif
+
+// 每个后端提供 console_tx_ready / console_tx_byte / console_rx_byte / console_flush，
+// 能一次输出整个字符串的后端另外定义 console_puts 和 CONSOLE_HAS_PUTS
+#if defined(CONSOLE_16550)
+
+#define CONSOLE_NAME "16550"
+
+// 寄存器间隔 4 字节
+#define CONSOLE_16550_RBR (CONSOLE_BASE + 0)
+#define CONSOLE_16550_THR (CONSOLE_BASE + 0)
+#define CONSOLE_16550_LSR (CONSOLE_BASE + 20)
+
+static inline uint8_t console_16550_lsr(void)
+{
+    uint8_t lsr = *(volatile uint8_t *)CONSOLE_16550_LSR;
+#ifdef UART_TELEMETRY
+    uart_telemetry_lsr(lsr);
+#endif
+    return lsr;
+}
+
+static inline int console_tx_ready(void)
+{
+    return console_16550_lsr() & 0x20;   // THRE
+}
+
+static inline void console_tx_byte(uint8_t c)
+{
+    *(volatile uint8_t *)CONSOLE_16550_THR = c;
+}
+
+static inline int console_rx_byte(uint8_t *c)
+{
+    if (!(console_16550_lsr() & 0x01))    // DR
+        return 0;
+    *c = *(volatile uint8_t *)CONSOLE_16550_RBR;
+    return 1;
+}
+
+static inline void console_flush(void)
+{
+    while (!(console_16550_lsr() & 0x40)) {}    // TEMT
+}
+
+#elif defined(CONSOLE_JTAG)
+
+#define CONSOLE_NAME "jtag"
+
+// DATA: [7:0] 数据, [15] RVALID, [31:16] RAVAIL；读一次即弹出一个字符
+// CONTROL: [31:16] WSPACE（发送 FIFO 剩余空间）
+#define CONSOLE_JTAG_DATA    (CONSOLE_BASE + 0)
+#define CONSOLE_JTAG_CONTROL (CONSOLE_BASE + 4)
+#define CONSOLE_JTAG_RVALID  (1u << 15)
+
+// 与原驱动一致，至少留 8 个空位再写，避免主机端未连接时 FIFO 写满后阻塞在中间
+#ifndef CONSOLE_JTAG_TX_MIN_SPACE
+#define CONSOLE_JTAG_TX_MIN_SPACE 8
+#endif
+
+#ifndef CONSOLE_JTAG_FIFO_DEPTH
+#define CONSOLE_JTAG_FIFO_DEPTH 64
+#endif
+
+static inline uint32_t console_jtag_wspace(void)
+{
+    return *(volatile uint32_t *)CONSOLE_JTAG_CONTROL >> 16;
+}
+
+static inline int console_tx_ready(void)
+{
+    return console_jtag_wspace() >= CONSOLE_JTAG_TX_MIN_SPACE;
+}
+
+static inline void console_tx_byte(uint8_t c)
+{
+    *(volatile uint32_t *)CONSOLE_JTAG_DATA = c;
+}
+
+// 发送 FIFO 中尚未被主机取走的字节数
+static inline uint32_t console_tx_level(void)
+{
+    return CONSOLE_JTAG_FIFO_DEPTH - console_jtag_wspace();
+}
+#define CONSOLE_HAS_TX_LEVEL
+
+// 状态和数据在同一个寄存器里，必须一次读出再判断 RVALID
+static inline int console_rx_byte(uint8_t *c)
+{
+    uint32_t data = *(volatile uint32_t *)CONSOLE_JTAG_DATA;
+    if (!(data & CONSOLE_JTAG_RVALID))
+        return 0;
+    *c = (uint8_t)data;
+    return 1;
+}
+
+// 只能等到发送 FIFO 清空；主机端没有连接时会一直等待
+static inline void console_flush(void)
+{
+    while (console_jtag_wspace() < CONSOLE_JTAG_FIFO_DEPTH) {}
+}
+
+#elif defined(CONSOLE_RING)
+
+#define CONSOLE_NAME "ring"
+
+// 大小必须是 2 的幂；写满后覆盖最旧的数据
+#ifndef CONSOLE_RING_SIZE
+#define CONSOLE_RING_SIZE 4096
+#endif
+
+#ifndef CONSOLE_RING_RX_SIZE
+#define CONSOLE_RING_RX_SIZE 64
+#endif
+
+#define CONSOLE_RING_MAGIC 0x534e4f43   // "CONS"
+
+// 调试器读取方法：tx_head 为累计写入字节数，有效数据为
+// tx[(tx_head - n) % size .. tx_head % size)，n = min(tx_head, size)
+// 输入：调试器写 rx[rx_head % rx_size] 后递增 rx_head，程序递增 rx_tail
+typedef struct {
+    uint32_t          magic;
+    uint32_t          size;
+    uint32_t          rx_size;
+    uint32_t          reserved;
+    volatile uint64_t tx_head;
+    volatile uint64_t rx_head;
+    volatile uint64_t rx_tail;
+    volatile uint8_t  tx[CONSOLE_RING_SIZE];
+    volatile uint8_t  rx[CONSOLE_RING_RX_SIZE];
+} console_ring_t;
+
+extern console_ring_t console_ring;
+
+static inline int console_tx_ready(void)
+{
+    return 1;
+}
+
+static inline void console_tx_byte(uint8_t c)
+{
+    uint64_t head = console_ring.tx_head;
+    console_ring.tx[head & (CONSOLE_RING_SIZE - 1)] = c;
+    console_ring.tx_head = head + 1;
+}
+
+static inline int console_rx_byte(uint8_t *c)
+{
+    uint64_t tail = console_ring.rx_tail;
+    if (tail == console_ring.rx_head)
+        return 0;
+    *c = console_ring.rx[tail & (CONSOLE_RING_RX_SIZE - 1)];
+    console_ring.rx_tail = tail + 1;
+    return 1;
+}
+
+// 接收缓冲区中调试器已写入、程序尚未读取的字节数
+static inline uint32_t console_rx_level(void)
+{
+    return (uint32_t)(console_ring.rx_head - console_ring.rx_tail);
+}
+#define CONSOLE_HAS_RX_LEVEL
+
+static inline void console_flush(void)
+{
+}
+
+#elif defined(CONSOLE_SEMIHOST)
+
+#define CONSOLE_NAME "semihost"
+
+#define SEMIHOST_SYS_WRITEC 0x03
+#define SEMIHOST_SYS_WRITE0 0x04
+#define SEMIHOST_SYS_READC  0x07
+
+// RISC-V 半主机约定：slli/ebreak/srai 三条非压缩指令，a0 为操作号，a1 为参数
+// 没有连接调试器或仿真器不支持时 ebreak 会进入异常处理
+static inline long console_semihost(long op, long arg)
+{
+    register long a0 asm("a0") = op;
+    register long a1 asm("a1") = arg;
+    __asm__ volatile(
+        ".option push\n"
+        ".option norvc\n"
+        ".balign 16\n"      // 三条指令不能跨页
+        "slli x0, x0, 0x1f\n"
+        "ebreak\n"
+        "srai x0, x0, 7\n"
+        ".option pop\n"
+        : "+r"(a0)
+        : "r"(a1)
+        : "memory");
+    return a0;
+}
+
+static inline int console_tx_ready(void)
+{
+    return 1;
+}
+
+static inline void console_tx_byte(uint8_t c)
+{
+    char ch = c;
+    console_semihost(SEMIHOST_SYS_WRITEC, (long)&ch);
+}
+
+// SYS_READC 本身会阻塞；rvsim 在没有输入时返回 -1，这里当作没有数据
+static inline int console_rx_byte(uint8_t *c)
+{
+    long r = console_semihost(SEMIHOST_SYS_READC, 0);
+    if (r < 0)
+        return 0;
+    *c = (uint8_t)r;
+    return 1;
+}
+
+static inline void console_puts(const char *str)
+{
+    console_semihost(SEMIHOST_SYS_WRITE0, (long)str);
+}
+#define CONSOLE_HAS_PUTS
+
+static inline void console_flush(void)
+{
+}
+
+#endif
+
+// 当前后端名称，用于在启动信息中说明输出去向
+const char *console_name(void);
@@ -0,0 +1,22 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Callee-Saved Register Context Switch (context.S)
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+// 只保存被调用者保存的寄存器，其余寄存器按调用约定由调用 context_switch 的一方负责
+// 布局需与 context.S 保持一致
+typedef struct {
+    uint64_t ra;
+    uint64_t sp;
+    uint64_t s[12];
+} context_t;
+
+// 把当前寄存器保存到 from，载入 to 并从 to->ra 继续执行
+void context_switch(context_t *from, context_t *to);
+
+// 新上下文的入口：以 s0 为参数调用 s1，s1 不应返回
+void context_trampoline(void);
@@ -0,0 +1,410 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     CoreMark-Style CPU Workload (list / matrix / state machine / CRC)
+//////////////////////////////////////////////////////////////////////////////////
+
+// 按 CoreMark 的结构移植到本裸机环境：链表查找与排序、矩阵运算、
+// 数字字符串状态机，以及串联全部结果的 CRC16。每次迭代的种子来自上一轮
+// 的 CRC，编译器无法把循环提前算出。这不是 EEMBC 官方源码，分数只能
+// 用于本仓库内不同编译选项 / 内核配置之间的横向比较。
+//
+// make MAIN=coremark EXTRA_CFLAGS="-DCOREMARK_ITERATIONS=200"
+
+#include <stdint.h>
+#include "uart.h"
+#include "bench.h"
+
+#ifndef COREMARK_ITERATIONS
+#define COREMARK_ITERATIONS 20
+#endif
+
+#define LIST_NODES  64
+#define MATRIX_N    12
+#define STATE_LEN   256
+
+// 以默认迭代次数跑完后的 CRC，由同一份源码在主机上算出
+#define COREMARK_EXPECTED_CRC_20 0x2b7c
+
+/////////////////////////////////////////////////////
+// CRC16 (CCITT, 逐位计算，与 CoreMark 的 crcu16 同构)
+/////////////////////////////////////////////////////
+
+static uint16_t crc16_u8(uint8_t data, uint16_t crc)
+{
+    for (int i = 0; i < 8; i++) {
+        uint8_t x16 = (data & 1) ^ (crc & 1);
+        data >>= 1;
+        if (x16 == 1) {
+            crc ^= 0x4002;
+            crc >>= 1;
+            crc |= 0x8000;
+        } else {
+            crc >>= 1;
+        }
+    }
+    return crc;
+}
+
+static uint16_t crc16_u16(uint16_t data, uint16_t crc)
+{
+    crc = crc16_u8((uint8_t)data, crc);
+    return crc16_u8((uint8_t)(data >> 8), crc);
+}
+
+static uint16_t crc16_u32(uint32_t data, uint16_t crc)
+{
+    crc = crc16_u16((uint16_t)data, crc);
+    return crc16_u16((uint16_t)(data >> 16), crc);
+}
+
+/////////////////////////////////////////////////////
+// 链表
+/////////////////////////////////////////////////////
+
+typedef struct list_node {
+    struct list_node *next;
+    int16_t data;
+    int16_t idx;
+} list_node_t;
+
+static list_node_t list_pool[LIST_NODES];
+
+static list_node_t *list_init(uint16_t seed)
+{
+    for (int i = 0; i < LIST_NODES; i++) {
+        list_pool[i].next = (i + 1 < LIST_NODES) ? &list_pool[i + 1] : 0;
+        list_pool[i].idx = i;
+        list_pool[i].data = (int16_t)(((seed ^ (i * 0x1d3)) & 0x7ff) - 0x400);
+    }
+    return &list_pool[0];
+}
+
+static list_node_t *list_find(list_node_t *list, int16_t data)
+{
+    while (list && list->data != data)
+        list = list->next;
+    return list;
+}
+
+static list_node_t *list_reverse(list_node_t *list)
+{
+    list_node_t *prev = 0;
+    while (list) {
+        list_node_t *next = list->next;
+        list->next = prev;
+        prev = list;
+        list = next;
+    }
+    return prev;
+}
+
+// 自底向上归并排序，key 选择按 data 或按 idx 排序
+static list_node_t *list_sort(list_node_t *list, int by_idx)
+{
+    int insize = 1;
+    for (;;) {
+        list_node_t *p = list;
+        list_node_t *tail = 0;
+        int nmerges = 0;
+        list = 0;
+        while (p) {
+            nmerges++;
+            list_node_t *q = p;
+            int psize = 0;
+            for (int i = 0; i < insize && q; i++) {
+                psize++;
+                q = q->next;
+            }
+            int qsize = insize;
+            while (psize > 0 || (qsize > 0 && q)) {
+                list_node_t *e;
+                if (psize == 0) {
+                    e = q; q = q->next; qsize--;
+                } else if (qsize == 0 || !q) {
+                    e = p; p = p->next; psize--;
+                } else {
+                    int16_t kp = by_idx ? p->idx : p->data;
+                    int16_t kq = by_idx ? q->idx : q->data;
+                    if (kp <= kq) {
+                        e = p; p = p->next; psize--;
+                    } else {
+                        e = q; q = q->next; qsize--;
+                    }
+                }
+                if (tail)
+                    tail->next = e;
+                else
+                    list = e;
+                tail = e;
+            }
+            p = q;
+        }
+        tail->next = 0;
+        if (nmerges <= 1)
+            return list;
+        insize *= 2;
+    }
+}
+
+static uint16_t bench_list(uint16_t seed, uint16_t crc)
+{
+    list_node_t *list = list_init(seed);
+    int16_t found = 0;
+    int16_t missed = 0;
+
+    for (int i = 0; i < 8; i++) {
+        int16_t key = (int16_t)(((seed ^ (i * 0x1d3 * 3)) & 0x7ff) - 0x400);
+        list_node_t *n = list_find(list, key);
+        if (n) {
+            found++;
+            crc = crc16_u16(n->idx, crc);
+        } else {
+            missed++;
+        }
+        list = list_reverse(list);
+    }
+
+    list = list_sort(list, 0);
+    for (list_node_t *n = list; n; n = n->next)
+        crc = crc16_u16(n->data, crc);
+    list = list_sort(list, 1);
+    crc = crc16_u16(list->data, crc);
+
+    crc = crc16_u16(found, crc);
+    return crc16_u16(missed, crc);
+}
+
+/////////////////////////////////////////////////////
+// 矩阵
+/////////////////////////////////////////////////////
+
+static int16_t mat_a[MATRIX_N * MATRIX_N];
+static int16_t mat_b[MATRIX_N * MATRIX_N];
+static int32_t mat_c[MATRIX_N * MATRIX_N];
+
+static uint16_t matrix_sum(uint16_t crc)
+{
+    int32_t sum = 0;
+    int32_t prev = 0;
+    int16_t ret = 0;
+    for (int i = 0; i < MATRIX_N * MATRIX_N; i++) {
+        int32_t v = mat_c[i];
+        sum += v;
+        if (sum > 0x4000) {
+            ret += 10;
+            sum = 0;
+        } else {
+            ret += (v > prev) ? 1 : 0;
+        }
+        prev = v;
+    }
+    return crc16_u16((uint16_t)ret, crc);
+}
+
+static uint16_t bench_matrix(uint16_t seed, uint16_t crc)
+{
+    int16_t val = (int16_t)(seed | 0xf000);
+
+    for (int i = 0; i < MATRIX_N * MATRIX_N; i++) {
+        mat_a[i] = (int16_t)((seed * (i + 1)) & 0xff);
+        mat_b[i] = (int16_t)(((seed ^ i) * 3) & 0xff) - 0x80;
+    }
+
+    for (int i = 0; i < MATRIX_N * MATRIX_N; i++)
+        mat_a[i] += val;
+    for (int i = 0; i < MATRIX_N * MATRIX_N; i++)
+        mat_c[i] = (int32_t)mat_a[i] * val;
+    crc = matrix_sum(crc);
+
+    for (int i = 0; i < MATRIX_N; i++) {
+        int32_t acc = 0;
+        for (int j = 0; j < MATRIX_N; j++)
+            acc += (int32_t)mat_a[i * MATRIX_N + j] * mat_b[j];
+        mat_c[i] = acc;
+    }
+    crc = matrix_sum(crc);
+
+    for (int i = 0; i < MATRIX_N; i++)
+        for (int j = 0; j < MATRIX_N; j++) {
+            int32_t acc = 0;
+            for (int k = 0; k < MATRIX_N; k++)
+                acc += (int32_t)mat_a[i * MATRIX_N + k] * mat_b[k * MATRIX_N + j];
+            mat_c[i * MATRIX_N + j] = acc;
+        }
+    crc = matrix_sum(crc);
+
+    // 按位段提取再相乘
+    for (int i = 0; i < MATRIX_N; i++)
+        for (int j = 0; j < MATRIX_N; j++) {
+            int32_t acc = 0;
+            for (int k = 0; k < MATRIX_N; k++) {
+                int32_t tmp = (int32_t)mat_a[i * MATRIX_N + k] * mat_b[k * MATRIX_N + j];
+                acc += ((tmp >> 2) & 0xf) * ((tmp >> 5) & 0x7f);
+            }
+            mat_c[i * MATRIX_N + j] = acc;
+        }
+    crc = matrix_sum(crc);
+
+    for (int i = 0; i < MATRIX_N * MATRIX_N; i++)
+        mat_a[i] -= val;
+    return crc;
+}
+
+/////////////////////////////////////////////////////
+// 状态机：扫描逗号分隔的数字串
+/////////////////////////////////////////////////////
+
+enum {
+    ST_START, ST_INVALID, ST_S1, ST_S2, ST_INT, ST_FLOAT, ST_EXPONENT, ST_SCIENTIFIC, ST_COUNT
+};
+
+static char state_buf[STATE_LEN];
+
+static const char *const state_tokens[] = {
+    "5012", "1234", "-874", "+122",
+    "35.54", ".1234", "-110.7", "+0.64",
+    "5.5e+3", "-.123e-2", "-87e+832", "+0.6e-12",
+    "T0.3e-1F", "-T.T++Tq", "1T3.4e4z", "34.0e-T^"
+};
+
+static void state_fill(uint16_t seed)
+{
+    int pos = 0;
+    uint32_t rnd = seed | 1;
+    while (pos < STATE_LEN - 12) {
+        const char *tok = state_tokens[bench_rand(&rnd) & 0xf];
+        while (*tok)
+            state_buf[pos++] = *tok++;
+        state_buf[pos++] = ',';
+    }
+    while (pos < STATE_LEN)
+        state_buf[pos++] = 0;
+}
+
+static int is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static int state_next(const char **str, uint32_t *transitions)
+{
+    const char *p = *str;
+    int state = ST_START;
+
+    for (; *p && state != ST_INVALID; p++) {
+        char c = *p;
+        if (c == ',') {
+            p++;
+            break;
+        }
+        int next = state;
+        switch (state) {
+        case ST_START:
+            if (is_digit(c))                next = ST_INT;
+            else if (c == '+' || c == '-')  next = ST_S1;
+            else if (c == '.')              next = ST_FLOAT;
+            else                            next = ST_INVALID;
+            break;
+        case ST_S1:
+            if (is_digit(c))                next = ST_INT;
+            else if (c == '.')              next = ST_FLOAT;
+            else                            next = ST_INVALID;
+            break;
+        case ST_INT:
+            if (c == '.')                   next = ST_FLOAT;
+            else if (!is_digit(c))          next = ST_INVALID;
+            break;
+        case ST_FLOAT:
+            if (c == 'E' || c == 'e')       next = ST_S2;
+            else if (!is_digit(c))          next = ST_INVALID;
+            break;
+        case ST_S2:
+            if (c == '+' || c == '-')       next = ST_EXPONENT;
+            else                            next = ST_INVALID;
+            break;
+        case ST_EXPONENT:
+            if (is_digit(c))                next = ST_SCIENTIFIC;
+            else                            next = ST_INVALID;
+            break;
+        case ST_SCIENTIFIC:
+            if (!is_digit(c))               next = ST_INVALID;
+            break;
+        }
+        if (next != state)
+            transitions[state]++;
+        state = next;
+    }
+    *str = p;
+    return state;
+}
+
+static uint16_t bench_state(uint16_t seed, uint16_t crc)
+{
+    uint32_t final_counts[ST_COUNT];
+    uint32_t transitions[ST_COUNT];
+    for (int i = 0; i < ST_COUNT; i++) {
+        final_counts[i] = 0;
+        transitions[i] = 0;
+    }
+
+    state_fill(seed);
+    const char *p = state_buf;
+    while (*p)
+        final_counts[state_next(&p, transitions)]++;
+
+    // 按种子破坏部分字符后再扫一遍
+    for (int i = seed & 7; i < STATE_LEN && state_buf[i]; i += 9)
+        state_buf[i] ^= 0x02;
+    p = state_buf;
+    while (*p)
+        final_counts[state_next(&p, transitions)]++;
+
+    for (int i = 0; i < ST_COUNT; i++) {
+        crc = crc16_u32(final_counts[i], crc);
+        crc = crc16_u32(transitions[i], crc);
+    }
+    return crc;
+}
+
+/////////////////////////////////////////////////////
+
+static uint16_t coremark_iterate(uint32_t iterations)
+{
+    uint16_t crc = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        uint16_t seed = crc ^ (uint16_t)(i * 0x3415);
+        crc = bench_list(seed, crc);
+        crc = bench_matrix(seed, crc);
+        crc = bench_state(seed, crc);
+    }
+    return crc;
+}
+
+int main()
+{
+    if (init_uart(PLAT_CLK_FREQ, PLAT_UART_BAUD) != 0)
+        return 1;
+    bench_header("CoreMark-Style Workload");
+
+    print_uart("=== coremark ===\n");
+    bench_t b;
+    bench_start(&b);
+    uint16_t crc = coremark_iterate(COREMARK_ITERATIONS);
+    bench_stop(&b);
+
+    int errors = 0;
+    if (COREMARK_ITERATIONS == 20 && crc != COREMARK_EXPECTED_CRC_20)
+        errors++;
+
+    printf_uart("Iterations: %u, final CRC: 0x%x\n", COREMARK_ITERATIONS, crc);
+    bench_report("coremark", &b, COREMARK_ITERATIONS, errors);
+
+    // 每MHz分数：iterations * 1e6 / cycles，与主频无关
+    print_uart("Score: ");
+    bench_print_milli((uint64_t)COREMARK_ITERATIONS * 1000000000ULL / b.cycles);
+    print_uart(" iterations/MHz-s\n");
+    if (COREMARK_ITERATIONS != 20)
+        print_uart("(CRC self-check only covers the default iteration count)\n");
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     RISC-V CSR Access Helpers
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+#define read_csr(reg) ({ uint64_t __tmp; \
+    __asm__ volatile ("csrr %0, " #reg : "=r"(__tmp)); \
+    __tmp; })
+
+#define write_csr(reg, val) ({ \
+    __asm__ volatile ("csrw " #reg ", %0" :: "rK"(val)); })
+
+#define set_csr(reg, bit) ({ uint64_t __tmp; \
+    __asm__ volatile ("csrrs %0, " #reg ", %1" : "=r"(__tmp) : "rK"(bit)); \
+    __tmp; })
+
+#define clear_csr(reg, bit) ({ uint64_t __tmp; \
+    __asm__ volatile ("csrrc %0, " #reg ", %1" : "=r"(__tmp) : "rK"(bit)); \
+    __tmp; })
+
+#define MSTATUS_MIE     0x00000008
+#define MSTATUS_MPIE    0x00000080
+#define MSTATUS_VS      0x00000600
+#define MSTATUS_VS_INIT 0x00000200
+
+// misa 中扩展字母对应的位，如 MISA_EXT('V')
+#define MISA_EXT(c)     (1ULL << ((c) - 'A'))
+
+#define MIP_MSIP        (1 << 3)
+#define MIP_MTIP        (1 << 7)
+#define MIP_MEIP        (1 << 11)
+
+#define MCAUSE_INT      (1ULL << 63)
+
+static inline uint64_t read_mcycle(void)
+{
+    return read_csr(mcycle);
+}
+
+static inline uint64_t read_minstret(void)
+{
+    return read_csr(minstret);
+}
+
+static inline uint64_t read_mhartid(void)
+{
+    return read_csr(mhartid);
+}
+
+static inline void wfi(void)
+{
+    __asm__ volatile ("wfi");
+}
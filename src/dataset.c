@@ -0,0 +1,98 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Datasets Linked from data/manifest (utils/datapack.py)
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "dataset.h"
+#include "isa.h"
+#include "mem.h"
+#include <stdint.h>
+#include <stddef.h>
+
+// 没有生成 datasets.S 时（如只包含了 dataset.h）表为空
+__attribute__((weak)) const dataset_t dataset_table[1];
+__attribute__((weak)) const uint32_t dataset_count = 0;
+
+const dataset_t *dataset_find(const char *name)
+{
+    for (uint32_t i = 0; i < dataset_count; i++) {
+        const char *a = dataset_table[i].name, *b = name;
+        while (*a && *a == *b) {
+            a++;
+            b++;
+        }
+        if (*a == *b)
+            return &dataset_table[i];
+    }
+    return NULL;
+}
+
+int64_t lz4_decompress(const void *src, uint64_t len, void *dst, uint64_t cap)
+{
+    const uint8_t *ip = src, *iend = ip + len;
+    uint8_t *op = dst, *oend = op + cap;
+
+    while (ip < iend) {
+        uint8_t token = *ip++;
+        uint64_t n = token >> 4;
+        if (n == 15) {
+            uint8_t b;
+            do {
+                if (ip >= iend)
+                    return -1;
+                b = *ip++;
+                n += b;
+            } while (b == 255);
+        }
+        if (n > (uint64_t)(iend - ip) || n > (uint64_t)(oend - op))
+            return -1;
+        memcpy(op, ip, n);
+        op += n;
+        ip += n;
+        // 最后一个序列只有字面量
+        if (ip >= iend)
+            break;
+
+        if (iend - ip < 2)
+            return -1;
+        uint64_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (uint64_t)(op - (uint8_t *)dst))
+            return -1;
+        n = token & 15;
+        if (n == 15) {
+            uint8_t b;
+            do {
+                if (ip >= iend)
+                    return -1;
+                b = *ip++;
+                n += b;
+            } while (b == 255);
+        }
+        n += 4;
+        if (n > (uint64_t)(oend - op))
+            return -1;
+        // 匹配可能与输出重叠，逐字节复制
+        const uint8_t *m = op - offset;
+        while (n--)
+            *op++ = *m++;
+    }
+    return op - (uint8_t *)dst;
+}
+
+int64_t dataset_load(const dataset_t *ds, void *dst, uint64_t cap)
+{
+    if (ds->raw_size > cap)
+        return -1;
+    if (ds->flags & DATASET_LZ4) {
+        int64_t n = lz4_decompress(ds->data, ds->size, dst, cap);
+        return n == (int64_t)ds->raw_size ? n : -1;
+    }
+    memcpy(dst, ds->data, ds->raw_size);
+    return (int64_t)ds->raw_size;
+}
+
+int dataset_verify(const dataset_t *ds, const void *buf)
+{
+    return isa_crc32(0, buf, ds->raw_size) == ds->crc32 ? 0 : -1;
+}
@@ -0,0 +1,43 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Datasets Linked from data/manifest (utils/datapack.py)
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+// 程序包含生成的 datasets.h 时，Makefile 运行 utils/datapack.py 并链接 build/data/datasets.S：
+//   #include "datasets.h"
+//   const int16_t *taps = ds_fir_taps;                          // 未压缩：直接访问
+//   static uint8_t buf[DS_NOISE_COUNT];
+//   dataset_load(&dataset_table[DATASET_NOISE], buf, sizeof(buf));   // compress=lz4：先解压
+
+#define DATASET_LZ4 1               // data 为 LZ4 块（utils/lz4pack.py 的格式）
+
+// 布局与 datapack.py 生成的 dataset_table 一致
+typedef struct {
+    const char *name;
+    const void *data;
+    uint64_t size;                  // data 的字节数（压缩时为压缩后大小）
+    uint64_t raw_size;              // 原始字节数
+    uint32_t elem_size;
+    uint32_t flags;
+    uint32_t crc32;                 // 原始内容的 CRC32（IEEE）
+    uint32_t reserved;
+} dataset_t;
+
+extern const dataset_t dataset_table[];
+extern const uint32_t dataset_count;
+
+// 按名字查找，找不到返回 NULL
+const dataset_t *dataset_find(const char *name);
+
+// 把数据集复制或解压到 dst，返回写入的字节数；容量不足或数据损坏时返回 -1
+int64_t dataset_load(const dataset_t *ds, void *dst, uint64_t cap);
+
+// 校验 buf 中 raw_size 字节的 CRC32，一致返回 0
+int dataset_verify(const dataset_t *ds, const void *buf);
+
+// 解压一个 LZ4 块，返回输出字节数，出错返回 -1
+int64_t lz4_decompress(const void *src, uint64_t len, void *dst, uint64_t cap);
@@ -0,0 +1,360 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Dhrystone 2.1-Style CPU Workload
+//////////////////////////////////////////////////////////////////////////////////
+
+// 保留 Dhrystone 2.1 的过程结构（Proc_1..Proc_8、Func_1..Func_3、记录、
+// 字符串比较与二维数组），去掉 libc 依赖：strcpy/strcmp 换成本地实现，
+// 结构体整体赋值改为逐字段拷贝，避免编译器生成 memcpy 调用。
+// 结束时按原版的期望值自检全局变量。
+//
+// make MAIN=dhrystone EXTRA_CFLAGS="-DDHRYSTONE_RUNS=20000"
+
+#include <stdint.h>
+#include "uart.h"
+#include "bench.h"
+
+#ifndef DHRYSTONE_RUNS
+#define DHRYSTONE_RUNS 2000
+#endif
+
+// VAX 11/780 的 Dhrystones/s，DMIPS = Dhrystones/s / 1757
+#define DHRYSTONE_VAX_MIPS 1757
+
+typedef enum { Ident_1, Ident_2, Ident_3, Ident_4, Ident_5 } Enumeration;
+
+typedef int     One_Thirty;
+typedef int     One_Fifty;
+typedef char    Capital_Letter;
+typedef int     Boolean;
+typedef char    Str_30[31];
+typedef int     Arr_1_Dim[50];
+typedef int     Arr_2_Dim[50][50];
+
+typedef struct record {
+    struct record *Ptr_Comp;
+    Enumeration    Discr;
+    Enumeration    Enum_Comp;
+    int            Int_Comp;
+    Str_30         Str_Comp;
+} Rec_Type, *Rec_Pointer;
+
+#define true  1
+#define false 0
+
+static Rec_Type     Rec_Glob;
+static Rec_Type     Next_Rec_Glob;
+static Rec_Pointer  Ptr_Glob;
+static Rec_Pointer  Next_Ptr_Glob;
+static int          Int_Glob;
+static Boolean      Bool_Glob;
+static char         Ch_1_Glob;
+static char         Ch_2_Glob;
+static Arr_1_Dim    Arr_1_Glob;
+static Arr_2_Dim    Arr_2_Glob;
+
+static void Proc_3(Rec_Pointer *Ptr_Ref_Par);
+static void Proc_6(Enumeration Enum_Val_Par, Enumeration *Enum_Ref_Par);
+static void Proc_7(One_Fifty Int_1_Par_Val, One_Fifty Int_2_Par_Val, One_Fifty *Int_Par_Ref);
+static Boolean Func_3(Enumeration Enum_Par_Val);
+
+/////////////////////////////////////////////////////
+// 字符串与记录拷贝
+/////////////////////////////////////////////////////
+
+static void str_copy(char *dst, const char *src)
+{
+    while ((*dst++ = *src++) != 0)
+        ;
+}
+
+static int str_cmp(const char *a, const char *b)
+{
+    while (*a && *a == *b) {
+        a++;
+        b++;
+    }
+    return (unsigned char)*a - (unsigned char)*b;
+}
+
+static void rec_copy(Rec_Pointer dst, const Rec_Type *src)
+{
+    dst->Ptr_Comp = src->Ptr_Comp;
+    dst->Discr = src->Discr;
+    dst->Enum_Comp = src->Enum_Comp;
+    dst->Int_Comp = src->Int_Comp;
+    str_copy(dst->Str_Comp, src->Str_Comp);
+}
+
+/////////////////////////////////////////////////////
+// 过程
+/////////////////////////////////////////////////////
+
+static void Proc_1(Rec_Pointer Ptr_Val_Par)
+{
+    Rec_Pointer Next_Record = Ptr_Val_Par->Ptr_Comp;
+
+    rec_copy(Ptr_Val_Par->Ptr_Comp, Ptr_Glob);
+    Ptr_Val_Par->Int_Comp = 5;
+    Next_Record->Int_Comp = Ptr_Val_Par->Int_Comp;
+    Next_Record->Ptr_Comp = Ptr_Val_Par->Ptr_Comp;
+    Proc_3(&Next_Record->Ptr_Comp);
+    if (Next_Record->Discr == Ident_1) {
+        Next_Record->Int_Comp = 6;
+        Proc_6(Ptr_Val_Par->Enum_Comp, &Next_Record->Enum_Comp);
+        Next_Record->Ptr_Comp = Ptr_Glob->Ptr_Comp;
+        Proc_7(Next_Record->Int_Comp, 10, &Next_Record->Int_Comp);
+    } else {
+        rec_copy(Ptr_Val_Par, Ptr_Val_Par->Ptr_Comp);
+    }
+}
+
+static void Proc_2(One_Fifty *Int_Par_Ref)
+{
+    One_Fifty   Int_Loc;
+    Enumeration Enum_Loc = Ident_2;
+
+    Int_Loc = *Int_Par_Ref + 10;
+    do {
+        if (Ch_1_Glob == 'A') {
+            Int_Loc -= 1;
+            *Int_Par_Ref = Int_Loc - Int_Glob;
+            Enum_Loc = Ident_1;
+        }
+    } while (Enum_Loc != Ident_1);
+}
+
+static void Proc_3(Rec_Pointer *Ptr_Ref_Par)
+{
+    if (Ptr_Glob != 0)
+        *Ptr_Ref_Par = Ptr_Glob->Ptr_Comp;
+    Proc_7(10, Int_Glob, &Ptr_Glob->Int_Comp);
+}
+
+static void Proc_4(void)
+{
+    Boolean Bool_Loc;
+
+    Bool_Loc = Ch_1_Glob == 'A';
+    Bool_Glob = Bool_Loc | Bool_Glob;
+    Ch_2_Glob = 'B';
+}
+
+static void Proc_5(void)
+{
+    Ch_1_Glob = 'A';
+    Bool_Glob = false;
+}
+
+static void Proc_6(Enumeration Enum_Val_Par, Enumeration *Enum_Ref_Par)
+{
+    *Enum_Ref_Par = Enum_Val_Par;
+    if (!Func_3(Enum_Val_Par))
+        *Enum_Ref_Par = Ident_4;
+    switch (Enum_Val_Par) {
+    case Ident_1:
+        *Enum_Ref_Par = Ident_1;
+        break;
+    case Ident_2:
+        if (Int_Glob > 100)
+            *Enum_Ref_Par = Ident_1;
+        else
+            *Enum_Ref_Par = Ident_4;
+        break;
+    case Ident_3:
+        *Enum_Ref_Par = Ident_2;
+        break;
+    case Ident_4:
+        break;
+    case Ident_5:
+        *Enum_Ref_Par = Ident_3;
+        break;
+    }
+}
+
+static void Proc_7(One_Fifty Int_1_Par_Val, One_Fifty Int_2_Par_Val, One_Fifty *Int_Par_Ref)
+{
+    One_Fifty Int_Loc;
+
+    Int_Loc = Int_1_Par_Val + 2;
+    *Int_Par_Ref = Int_2_Par_Val + Int_Loc;
+}
+
+static void Proc_8(Arr_1_Dim Arr_1_Par_Ref, Arr_2_Dim Arr_2_Par_Ref,
+                   int Int_1_Par_Val, int Int_2_Par_Val)
+{
+    One_Fifty Int_Index;
+    One_Fifty Int_Loc;
+
+    Int_Loc = Int_1_Par_Val + 5;
+    Arr_1_Par_Ref[Int_Loc] = Int_2_Par_Val;
+    Arr_1_Par_Ref[Int_Loc + 1] = Arr_1_Par_Ref[Int_Loc];
+    Arr_1_Par_Ref[Int_Loc + 30] = Int_Loc;
+    for (Int_Index = Int_Loc; Int_Index <= Int_Loc + 1; ++Int_Index)
+        Arr_2_Par_Ref[Int_Loc][Int_Index] = Int_Loc;
+    Arr_2_Par_Ref[Int_Loc][Int_Loc - 1] += 1;
+    Arr_2_Par_Ref[Int_Loc + 20][Int_Loc] = Arr_1_Par_Ref[Int_Loc];
+    Int_Glob = 5;
+}
+
+static Enumeration Func_1(Capital_Letter Ch_1_Par_Val, Capital_Letter Ch_2_Par_Val)
+{
+    Capital_Letter Ch_1_Loc;
+    Capital_Letter Ch_2_Loc;
+
+    Ch_1_Loc = Ch_1_Par_Val;
+    Ch_2_Loc = Ch_1_Loc;
+    if (Ch_2_Loc != Ch_2_Par_Val)
+        return Ident_1;
+    Ch_1_Glob = Ch_1_Loc;
+    return Ident_2;
+}
+
+static Boolean Func_2(Str_30 Str_1_Par_Ref, Str_30 Str_2_Par_Ref)
+{
+    One_Thirty     Int_Loc;
+    Capital_Letter Ch_Loc = 0;
+
+    Int_Loc = 2;
+    while (Int_Loc <= 2)
+        if (Func_1(Str_1_Par_Ref[Int_Loc], Str_2_Par_Ref[Int_Loc + 1]) == Ident_1) {
+            Ch_Loc = 'A';
+            Int_Loc += 1;
+        }
+    if (Ch_Loc >= 'W' && Ch_Loc < 'Z')
+        Int_Loc = 7;
+    if (Ch_Loc == 'R')
+        return true;
+    if (str_cmp(Str_1_Par_Ref, Str_2_Par_Ref) > 0) {
+        Int_Loc += 7;
+        Int_Glob = Int_Loc;
+        return true;
+    }
+    return false;
+}
+
+static Boolean Func_3(Enumeration Enum_Par_Val)
+{
+    Enumeration Enum_Loc;
+
+    Enum_Loc = Enum_Par_Val;
+    if (Enum_Loc == Ident_3)
+        return true;
+    return false;
+}
+
+/////////////////////////////////////////////////////
+
+static One_Fifty   Int_1_Loc;
+static One_Fifty   Int_2_Loc;
+static One_Fifty   Int_3_Loc;
+static Enumeration Enum_Loc;
+static Str_30      Str_1_Loc;
+static Str_30      Str_2_Loc;
+
+static void dhrystone_init(void)
+{
+    Next_Ptr_Glob = &Next_Rec_Glob;
+    Ptr_Glob = &Rec_Glob;
+
+    Ptr_Glob->Ptr_Comp = Next_Ptr_Glob;
+    Ptr_Glob->Discr = Ident_1;
+    Ptr_Glob->Enum_Comp = Ident_3;
+    Ptr_Glob->Int_Comp = 40;
+    str_copy(Ptr_Glob->Str_Comp, "DHRYSTONE PROGRAM, SOME STRING");
+    str_copy(Str_1_Loc, "DHRYSTONE PROGRAM, 1'ST STRING");
+
+    Arr_2_Glob[8][7] = 10;
+}
+
+static void dhrystone_run(uint32_t runs)
+{
+    Capital_Letter Ch_Index;
+
+    for (uint32_t Run_Index = 1; Run_Index <= runs; ++Run_Index) {
+        Proc_5();
+        Proc_4();
+        Int_1_Loc = 2;
+        Int_2_Loc = 3;
+        str_copy(Str_2_Loc, "DHRYSTONE PROGRAM, 2'ND STRING");
+        Enum_Loc = Ident_2;
+        Bool_Glob = !Func_2(Str_1_Loc, Str_2_Loc);
+        while (Int_1_Loc < Int_2_Loc) {
+            Int_3_Loc = 5 * Int_1_Loc - Int_2_Loc;
+            Proc_7(Int_1_Loc, Int_2_Loc, &Int_3_Loc);
+            Int_1_Loc += 1;
+        }
+        Proc_8(Arr_1_Glob, Arr_2_Glob, Int_1_Loc, Int_3_Loc);
+        Proc_1(Ptr_Glob);
+        for (Ch_Index = 'A'; Ch_Index <= Ch_2_Glob; ++Ch_Index) {
+            if (Enum_Loc == Func_1(Ch_Index, 'C')) {
+                Proc_6(Ident_1, &Enum_Loc);
+                str_copy(Str_2_Loc, "DHRYSTONE PROGRAM, 3'RD STRING");
+                Int_2_Loc = Run_Index;
+                Int_Glob = Run_Index;
+            }
+        }
+        Int_2_Loc = Int_2_Loc * Int_1_Loc;
+        Int_1_Loc = Int_2_Loc / Int_3_Loc;
+        Int_2_Loc = 7 * (Int_2_Loc - Int_3_Loc) - Int_1_Loc;
+        Proc_2(&Int_1_Loc);
+    }
+}
+
+// 对照原版程序结束时打印的 "should be" 值
+static int dhrystone_check(uint32_t runs)
+{
+    int errors = 0;
+
+    errors += Int_Glob != 5;
+    errors += Bool_Glob != 1;
+    errors += Ch_1_Glob != 'A';
+    errors += Ch_2_Glob != 'B';
+    errors += Arr_1_Glob[8] != 7;
+    errors += Arr_2_Glob[8][7] != (int)runs + 10;
+    errors += Ptr_Glob->Discr != Ident_1;
+    errors += Ptr_Glob->Enum_Comp != Ident_3;
+    errors += Ptr_Glob->Int_Comp != 17;
+    errors += str_cmp(Ptr_Glob->Str_Comp, "DHRYSTONE PROGRAM, SOME STRING") != 0;
+    errors += Next_Ptr_Glob->Discr != Ident_1;
+    errors += Next_Ptr_Glob->Enum_Comp != Ident_2;
+    errors += Next_Ptr_Glob->Int_Comp != 18;
+    errors += str_cmp(Next_Ptr_Glob->Str_Comp, "DHRYSTONE PROGRAM, SOME STRING") != 0;
+    errors += Int_1_Loc != 5;
+    errors += Int_2_Loc != 13;
+    errors += Int_3_Loc != 7;
+    errors += Enum_Loc != Ident_2;
+    errors += str_cmp(Str_1_Loc, "DHRYSTONE PROGRAM, 1'ST STRING") != 0;
+    errors += str_cmp(Str_2_Loc, "DHRYSTONE PROGRAM, 2'ND STRING") != 0;
+
+    return errors;
+}
+
+int main()
+{
+    if (init_uart(PLAT_CLK_FREQ, PLAT_UART_BAUD) != 0)
+        return 1;
+    bench_header("Dhrystone 2.1-Style Workload");
+
+    dhrystone_init();
+
+    print_uart("=== dhrystone ===\n");
+    bench_t b;
+    bench_start(&b);
+    dhrystone_run(DHRYSTONE_RUNS);
+    bench_stop(&b);
+
+    int errors = dhrystone_check(DHRYSTONE_RUNS);
+    printf_uart("Runs: %u, self-check mismatches: %d\n", DHRYSTONE_RUNS, errors);
+    bench_report("dhrystone", &b, DHRYSTONE_RUNS, errors);
+
+    // Dhrystones/(MHz*s) = runs * 1e6 / cycles，DMIPS/MHz 再除以 1757
+    uint64_t per_mhz_milli = (uint64_t)DHRYSTONE_RUNS * 1000000000ULL / b.cycles;
+    print_uart("Dhrystones per MHz: ");
+    bench_print_milli(per_mhz_milli);
+    print_uart("\nDMIPS/MHz: ");
+    bench_print_milli(per_mhz_milli / DHRYSTONE_VAX_MIPS);
+    print_uart("\n");
+
+    return 0;
+}
@@ -6,6 +6,16 @@
 
 #include <stdint.h>
 #include "uart.h"
+#include "uart_fmt.h"
+#include "hpm.h"
+#include "csr.h"
+#include "memkern.h"
+#include "cache.h"
+#include "result.h"
+#include "sections.h"
+#ifdef DRAM_DUMP
+#include "dump.h"
+#endif
 
 // 测试数据模式
 static const uint64_t test_patterns[] = {
@@ -32,6 +42,33 @@ static const uint64_t test_patterns[] = {
 #define TEST_SIZE         32    // 测试32个64位数据
 #define PATTERN_COUNT     (sizeof(test_patterns) / sizeof(test_patterns[0]))
 
+// 读回校验前的缓存处理（cache.h）：默认先写回并移出缓存，保证读到的是 PSRAM 而不是数据缓存；
+// -DDRAM_READ_MODE=CACHE_MODE_UNCACHED 通过非缓存方式读，CACHE_MODE_WARM 为原来的行为
+#ifndef DRAM_READ_MODE
+#define DRAM_READ_MODE    CACHE_MODE_COLD
+#endif
+
+// 批量测试区域放在 .dram_bss（NOLOAD，见 sections.h），前一半为源，后一半为目的
+#ifndef DRAM_BULK_BYTES
+#define DRAM_BULK_BYTES   (64 * 1024)
+#endif
+#define DRAM_BULK_WORDS   (DRAM_BULK_BYTES / 8 / 2)
+#define BULK_PATTERNS     4
+
+static uint64_t dram_bulk_buf[DRAM_BULK_WORDS * 2] __dram_bss __attribute__((aligned(64)));
+
+// 每个测试阶段统计的性能事件，平台不支持的事件会被跳过，取前 HPM_NUM_COUNTERS 个
+static const hpm_event_t dram_hpm_events[] = {
+    HPM_EV_L1D_MISS,
+    HPM_EV_L1D_ACCESS,
+    HPM_EV_LOAD,
+    HPM_EV_STORE,
+    HPM_EV_L1D_STALL,
+    HPM_EV_BRANCH_MISS,
+    HPM_EV_DTLB_MISS,
+    HPM_EV_L1I_MISS
+};
+
 // DRAM初始化
 void init_dram() {
     print_uart("DRAM initializing ...\n");
@@ -50,10 +87,22 @@ void init_dram() {
     *t_rx_clk_delay_address = t_rx_clk_delay_value;
     *address_mask_msb_address = address_mask_msb_value;
 
-    printf_uart("t_latency_access: %d\n", *t_latency_access_address);
-    printf_uart("t_read_write_recovery: %d\n", *t_read_write_recovery_address);
-    printf_uart("t_rx_clk_delay: %d\n", *t_rx_clk_delay_address);
-    printf_uart("address_mask_msb: %d\n\n", *address_mask_msb_address);
+    print_uart_fmt("t_latency_access: ", *t_latency_access_address, "\n");
+    print_uart_fmt("t_read_write_recovery: ", *t_read_write_recovery_address, "\n");
+    print_uart_fmt("t_rx_clk_delay: ", *t_rx_clk_delay_address, "\n");
+    print_uart_fmt("address_mask_msb: ", *address_mask_msb_address, "\n\n");
+}
+
+// 按 DRAM_READ_MODE 准备读回 [p, p+bytes)，返回读回用的地址
+static uint64_t *dram_readback_begin(uint64_t *p, size_t bytes)
+{
+    return cache_prepare(p, bytes, DRAM_READ_MODE);
+}
+
+static void dram_readback_end(void)
+{
+    if (DRAM_READ_MODE == CACHE_MODE_UNCACHED)
+        cache_uncached_end();
 }
 
 // 基本写入测试
@@ -92,10 +141,10 @@ void test_dram_write() {
 // 基本读取测试
 int test_dram_read() {
     print_uart("=== DRAM Read Test ===\n");
-    uint64_t* mem_base = (uint64_t*)DRAM_BASE_ADDR;
     int errors = 0;
 
-    print_uart("Reading back data from DRAM...\n");
+    printf_uart("Reading back data from DRAM (%s)...\n", cache_mode_name(DRAM_READ_MODE));
+    uint64_t* mem_base = dram_readback_begin((uint64_t*)DRAM_BASE_ADDR, TEST_SIZE * 8);
 
     for (int i = 0; i < TEST_SIZE; i++) {
         uint64_t expected = test_patterns[i % PATTERN_COUNT];
@@ -120,6 +169,7 @@ int test_dram_read() {
             print_uart("---\n");
         }
     }
+    dram_readback_end();
 
     print_uart("Read test completed. Errors: ");
     print_uart_byte(errors);
@@ -129,7 +179,7 @@ int test_dram_read() {
 }
 
 // 地址行测试
-void test_dram_address_lines() {
+int test_dram_address_lines() {
     print_uart("=== DRAM Address Lines Test ===\n");
     volatile uint64_t* mem_base = (volatile uint64_t*)DRAM_BASE_ADDR;
 
@@ -181,10 +231,11 @@ void test_dram_address_lines() {
     print_uart("Address lines test completed. Errors: ");
     print_uart_byte(addr_errors);
     print_uart("\n\n");
+    return addr_errors;
 }
 
 // 数据线测试
-void test_dram_data_lines() {
+int test_dram_data_lines() {
     print_uart("=== DRAM Data Lines Test ===\n");
     uint64_t* mem_base = (uint64_t*)DRAM_BASE_ADDR;
 
@@ -201,11 +252,17 @@ void test_dram_data_lines() {
 
     print_uart("Testing data lines with walking patterns...\n");
 
-    for (int i = 0; i < pattern_count && i < TEST_SIZE; i++) {
-        uint64_t pattern = walking_patterns[i];
-        *(mem_base + i) = pattern;
+    if (pattern_count > TEST_SIZE)
+        pattern_count = TEST_SIZE;
+
+    // 先写完全部图案，再对整段只做一次读回准备（cache_prepare 可能刷新整个缓存）
+    for (int i = 0; i < pattern_count; i++)
+        *(mem_base + i) = walking_patterns[i];
 
-        uint64_t readback = *(mem_base + i);
+    uint64_t* read_base = dram_readback_begin(mem_base, pattern_count * 8);
+    for (int i = 0; i < pattern_count; i++) {
+        uint64_t pattern = walking_patterns[i];
+        uint64_t readback = *(read_base + i);
 
         print_uart("Data[");
         print_uart_byte(i);
@@ -221,14 +278,16 @@ void test_dram_data_lines() {
             data_errors++;
         }
     }
+    dram_readback_end();
 
     print_uart("Data lines test completed. Errors: ");
     print_uart_byte(data_errors);
     print_uart("\n\n");
+    return data_errors;
 }
 
 // 压力测试 - 连续读写
-void test_dram_stress() {
+int test_dram_stress() {
     print_uart("=== DRAM Stress Test ===\n");
     uint64_t* mem_base = (uint64_t*)DRAM_BASE_ADDR;
     int stress_errors = 0;
@@ -247,9 +306,10 @@ void test_dram_stress() {
         }
 
         // 读取验证阶段
+        uint64_t* read_base = dram_readback_begin(mem_base, TEST_SIZE * 8);
         for (int i = 0; i < TEST_SIZE; i++) {
             uint64_t expected = test_patterns[i % PATTERN_COUNT] ^ (iteration << 8);
-            uint64_t actual = *(mem_base + i);
+            uint64_t actual = *(read_base + i);
 
             if (actual != expected) {
                 print_uart("  Error at position ");
@@ -262,6 +322,7 @@ void test_dram_stress() {
                 stress_errors++;
             }
         }
+        dram_readback_end();
 
         print_uart("  Iteration ");
         print_uart_byte(iteration);
@@ -271,10 +332,126 @@ void test_dram_stress() {
     print_uart("Stress test completed. Total errors: ");
     print_uart_byte(stress_errors);
     print_uart("\n\n");
+    return stress_errors;
+}
+
+static void print_bandwidth(const char *name, uint64_t bytes, uint64_t cycles)
+{
+    uint64_t milli = cycles ? bytes * 1000 / cycles : 0;
+    printf_uart("  %s: %lu cycles, %lu.%u%u%u bytes/cycle\n", name, cycles, milli / 1000,
+                (uint32_t)(milli / 100 % 10), (uint32_t)(milli / 10 % 10), (uint32_t)(milli % 10));
+}
+
+// 批量测试结果记为 bulk.<实现>.<操作>，如 bulk.rvv.copy_cold
+static void bulk_result(const char *op, uint64_t bytes, uint64_t cycles, int errors)
+{
+    char test[40];
+    int n = 0;
+    for (const char *p = "bulk."; *p; p++)
+        test[n++] = *p;
+    for (const char *p = memkern_impl_name(); *p && n < 20; p++)
+        test[n++] = *p;
+    test[n++] = '.';
+    for (const char *p = op; *p && n < (int)sizeof(test) - 1; p++)
+        test[n++] = *p;
+    test[n] = '\0';
+    result_emit(test, cycles, 0, bytes, errors);
+}
+
+// 批量填充/校验/拷贝/异或（src/memkern.c），有 V 扩展时标量和向量实现各跑一遍；
+// 校验和拷贝分别在缓存被清空后（cold）和数据刚访问过后（warm）计时
+int test_dram_bulk() {
+    print_uart("=== DRAM Bulk Test ===\n");
+    uint64_t* src = dram_bulk_buf;
+    uint64_t* dst = src + DRAM_BULK_WORDS;
+    const size_t words = DRAM_BULK_WORDS;
+    const size_t bytes = words * 8;
+    int errors = 0;
+    int has_vector = memkern_set_vector(1);
+
+    printf_uart("Cache flush: %s, %u-byte lines\n", cache_impl_name(), CACHE_LINE_BYTES);
+    for (int vec = 0; vec <= has_vector; vec++) {
+        uint64_t fill_cycles = 0, verify_cold = 0, verify_warm = 0;
+        uint64_t copy_cold = 0, copy_warm = 0, xor_cycles = 0;
+        memkern_set_vector(vec);
+        printf_uart("Kernels: %s, %u bytes per buffer\n", memkern_impl_name(), (uint32_t)bytes);
+
+        for (int p = 0; p < BULK_PATTERNS; p++) {
+            uint64_t pattern = test_patterns[p];
+            uint64_t t0 = read_csr(mcycle);
+            memkern_fill(src, pattern, words);
+            fill_cycles += read_csr(mcycle) - t0;
+
+            cache_flush_range(src, bytes);
+            t0 = read_csr(mcycle);
+            size_t bad_src = memkern_verify(src, pattern, words);
+            verify_cold += read_csr(mcycle) - t0;
+            t0 = read_csr(mcycle);
+            size_t bad_warm = memkern_verify(src, pattern, words);
+            verify_warm += read_csr(mcycle) - t0;
+
+            cache_flush_range(src, 2 * bytes);
+            t0 = read_csr(mcycle);
+            memkern_copy(dst, src, words);
+            copy_cold += read_csr(mcycle) - t0;
+            t0 = read_csr(mcycle);
+            memkern_copy(dst, src, words);
+            copy_warm += read_csr(mcycle) - t0;
+
+            cache_flush_range(dst, bytes);
+            size_t bad_dst = memkern_verify(dst, pattern, words);
+
+            // 注入一个错误，校验应定位到该位置，异或结果应随之改变
+            size_t poke = words / 3 + p;
+            dst[poke] = ~pattern;
+            size_t found = memkern_verify(dst, pattern, words);
+            t0 = read_csr(mcycle);
+            uint64_t x = memkern_xor(dst, words);
+            xor_cycles += read_csr(mcycle) - t0;
+            uint64_t expected_xor = ((words & 1) ? pattern : 0) ^ pattern ^ ~pattern;
+
+            if (bad_src != words || bad_warm != words || bad_dst != words || found != poke || x != expected_xor) {
+                printf_uart("  Error with pattern 0x%lx: src mismatch cold %lu warm %lu, dst mismatch %lu, "
+                            "injected %lu found %lu, xor 0x%lx expected 0x%lx\n",
+                            pattern, (uint64_t)bad_src, (uint64_t)bad_warm, (uint64_t)bad_dst, (uint64_t)poke,
+                            (uint64_t)found, x, expected_xor);
+                errors++;
+            }
+        }
+
+        uint64_t total = (uint64_t)bytes * BULK_PATTERNS;
+        print_bandwidth("fill       ", total, fill_cycles);
+        print_bandwidth("verify cold", total, verify_cold);
+        print_bandwidth("verify warm", total, verify_warm);
+        print_bandwidth("copy cold  ", total, copy_cold);
+        print_bandwidth("copy warm  ", total, copy_warm);
+        print_bandwidth("xor warm   ", total, xor_cycles);
+        bulk_result("fill", total, fill_cycles, errors);
+        bulk_result("verify_cold", total, verify_cold, errors);
+        bulk_result("verify_warm", total, verify_warm, errors);
+        bulk_result("copy_cold", total, copy_cold, errors);
+        bulk_result("copy_warm", total, copy_warm, errors);
+        bulk_result("xor_warm", total, xor_cycles, errors);
+    }
+    memkern_set_vector(has_vector);
+
+    print_uart("Bulk test completed. Errors: ");
+    print_uart_byte(errors);
+    print_uart("\n\n");
+    return errors;
+}
+
+#ifdef DRAM_DUMP
+// 压缩转储测试区域，由 utils/dump_recv.py 接收
+void test_dram_dump() {
+    print_uart("=== DRAM Dump ===\n");
+    dump_region((const void*)DRAM_BASE_ADDR, TEST_SIZE * 8);
+    print_uart("\nDump completed!\n\n");
 }
+#endif
 
 // 内存清零测试
-void test_dram_clear() {
+int test_dram_clear() {
     print_uart("=== DRAM Clear Test ===\n");
     uint64_t* mem_base = (uint64_t*)DRAM_BASE_ADDR;
 
@@ -307,11 +484,13 @@ void test_dram_clear() {
         print_uart(" errors\n");
     }
     print_uart("\n");
+    return clear_errors;
 }
 
 int main() {
     // 初始化UART、DRAM
-    init_uart(115000000, 115200);
+    if (init_uart(PLAT_CLK_FREQ, PLAT_UART_BAUD) != 0)
+        return 1;
     init_dram();
 
     print_uart("\n");
@@ -328,24 +507,69 @@ int main() {
     print_uart_hex_64b(TEST_SIZE * 8);
     print_uart(" bytes\n\n");
 
-    // 执行各项测试
+    int hpm_counters = hpm_configure(dram_hpm_events, sizeof(dram_hpm_events) / sizeof(dram_hpm_events[0]));
+    printf_uart("Performance counters: %d (%s event table)\n\n", hpm_counters, hpm_platform_name());
+
+    // 执行各项测试，每个阶段后输出周期数与缺失率，并记一条 @RESULT
+    hpm_region_t hpm;
+    int phase_errors;
+
+    hpm_region_begin(&hpm);
     test_dram_write();
+    hpm_region_end(&hpm);
+    hpm_region_print("write", &hpm);
+    result_emit("write", hpm.cycles, hpm.instret, TEST_SIZE * 8, 0);
+
+    hpm_region_begin(&hpm);
     int read_errors = test_dram_read();
-    test_dram_address_lines();
-    test_dram_data_lines();
-    test_dram_stress();
-    test_dram_clear();
+    hpm_region_end(&hpm);
+    hpm_region_print("read", &hpm);
+    result_emit("read", hpm.cycles, hpm.instret, TEST_SIZE * 8, read_errors);
+
+    hpm_region_begin(&hpm);
+    phase_errors = test_dram_address_lines();
+    hpm_region_end(&hpm);
+    hpm_region_print("address_lines", &hpm);
+    result_emit("address_lines", hpm.cycles, hpm.instret, 0, phase_errors);
+
+    hpm_region_begin(&hpm);
+    phase_errors = test_dram_data_lines();
+    hpm_region_end(&hpm);
+    hpm_region_print("data_lines", &hpm);
+    result_emit("data_lines", hpm.cycles, hpm.instret, 0, phase_errors);
+
+    hpm_region_begin(&hpm);
+    phase_errors = test_dram_stress();
+    hpm_region_end(&hpm);
+    hpm_region_print("stress", &hpm);
+    result_emit("stress", hpm.cycles, hpm.instret, 5 * 2 * TEST_SIZE * 8, phase_errors);
+
+    hpm_region_begin(&hpm);
+    int bulk_errors = test_dram_bulk();
+    hpm_region_end(&hpm);
+    hpm_region_print("bulk", &hpm);
+    result_emit("bulk", hpm.cycles, hpm.instret, 0, bulk_errors);
+#ifdef DRAM_DUMP
+    test_dram_dump();
+#endif
+
+    hpm_region_begin(&hpm);
+    phase_errors = test_dram_clear();
+    hpm_region_end(&hpm);
+    hpm_region_print("clear", &hpm);
+    result_emit("clear", hpm.cycles, hpm.instret, 2 * TEST_SIZE * 8, phase_errors);
+    print_uart("\n");
 
     // 测试总结
     print_uart("=========================================\n");
     print_uart("            Test Summary\n");
     print_uart("=========================================\n");
 
-    if (read_errors == 0) {
+    if (read_errors == 0 && bulk_errors == 0) {
         print_uart("✓ All DRAM tests PASSED!\n");
     } else {
         print_uart("✗ DRAM tests FAILED with ");
-        print_uart_byte(read_errors);
+        print_uart_byte(read_errors + bulk_errors);
         print_uart(" errors\n");
     }
 
@@ -0,0 +1,229 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Compressed Memory Dump over UART
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "dump.h"
+#include "uart.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#define TOKEN_LITERAL   0x00
+#define TOKEN_RUN       0x40
+#define TOKEN_ZERO      0x80
+#define TOKEN_MATCH     0xC0
+#define TOKEN_MAX_WORDS 64
+
+#define HASH_BITS       6
+#define HASH_EMPTY      0xFF
+
+#define FNV_OFFSET      0x811c9dc5u
+#define FNV_PRIME       0x01000193u
+
+static void dump_put_u16(uint16_t v)
+{
+    print_uart_char(v & 0xff);
+    print_uart_char(v >> 8);
+}
+
+static void dump_put_u32(uint32_t v)
+{
+    for (int i = 0; i < 4; i++)
+        print_uart_char((v >> (i * 8)) & 0xff);
+}
+
+static void dump_put_u64(uint64_t v)
+{
+    for (int i = 0; i < 8; i++)
+        print_uart_char((v >> (i * 8)) & 0xff);
+}
+
+static void dump_put_bytes(const uint8_t *p, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        print_uart_char(p[i]);
+}
+
+// 按32位半字计算FNV-1a，尾部不足一个字的部分按0补齐
+static uint32_t dump_checksum(const uint64_t *words, int n)
+{
+    uint32_t h = FNV_OFFSET;
+    for (int i = 0; i < n; i++) {
+        h = (h ^ (uint32_t)words[i]) * FNV_PRIME;
+        h = (h ^ (uint32_t)(words[i] >> 32)) * FNV_PRIME;
+    }
+    return h;
+}
+
+// 每个字只读一次DRAM；非对齐或尾部按字节读取
+static int dump_load_block(uintptr_t addr, uint32_t len, uint64_t *words)
+{
+    int nonzero = 0;
+
+    if ((addr & 7) == 0) {
+        volatile const uint64_t *src = (volatile const uint64_t *)addr;
+        for (uint32_t i = 0; i < len / 8; i++) {
+            words[i] = src[i];
+            nonzero |= (words[i] != 0);
+        }
+    }
+
+    for (uint32_t i = ((addr & 7) == 0) ? (len & ~7u) : 0; i < len; i += 8) {
+        uint64_t w = 0;
+        for (uint32_t b = 0; b < 8 && i + b < len; b++)
+            w |= (uint64_t)(*(volatile const uint8_t *)(addr + i + b)) << (b * 8);
+        words[i / 8] = w;
+        nonzero |= (w != 0);
+    }
+
+    return nonzero;
+}
+
+static inline uint32_t dump_hash(uint64_t w)
+{
+    return (uint32_t)((w * 0x9E3779B97F4A7C15ULL) >> (64 - HASH_BITS));
+}
+
+static uint8_t *dump_emit_literal(uint8_t *out, const uint64_t *words, int start, int end)
+{
+    while (start < end) {
+        int n = end - start;
+        if (n > TOKEN_MAX_WORDS)
+            n = TOKEN_MAX_WORDS;
+        *out++ = TOKEN_LITERAL | (n - 1);
+        for (int i = 0; i < n; i++) {
+            uint64_t w = words[start + i];
+            for (int b = 0; b < 8; b++)
+                *out++ = (w >> (b * 8)) & 0xff;
+        }
+        start += n;
+    }
+    return out;
+}
+
+// 编码一个块，返回payload长度
+static uint32_t dump_encode_block(const uint64_t *words, int n, uint8_t *payload)
+{
+    uint8_t last[1 << HASH_BITS];
+    uint8_t *out = payload;
+    int literal = 0;
+    int i = 0;
+
+    for (int k = 0; k < (1 << HASH_BITS); k++)
+        last[k] = HASH_EMPTY;
+
+    while (i < n) {
+        uint64_t w = words[i];
+        int len = 1;
+        uint8_t token = 0;
+        int dist = 0;
+
+        if (w == 0) {
+            while (i + len < n && len < TOKEN_MAX_WORDS && words[i + len] == 0)
+                len++;
+            token = TOKEN_ZERO;
+        } else if (i + 1 < n && words[i + 1] == w) {
+            while (i + len < n && len < TOKEN_MAX_WORDS && words[i + len] == w)
+                len++;
+            token = TOKEN_RUN;
+        } else {
+            uint8_t j = last[dump_hash(w)];
+            if (j != HASH_EMPTY && i + 1 < n && words[j] == w && words[j + 1] == words[i + 1]) {
+                len = 2;
+                while (i + len < n && len < TOKEN_MAX_WORDS && words[j + len] == words[i + len])
+                    len++;
+                token = TOKEN_MATCH;
+                dist = i - j;
+            } else {
+                len = 0;
+            }
+        }
+
+        if (len == 0) {
+            // 无可压缩模式，计入待输出的原始字
+            last[dump_hash(w)] = i;
+            i++;
+            continue;
+        }
+
+        out = dump_emit_literal(out, words, literal, i);
+        *out++ = token | (len - 1);
+        if (token == TOKEN_RUN) {
+            for (int b = 0; b < 8; b++)
+                *out++ = (w >> (b * 8)) & 0xff;
+        } else if (token == TOKEN_MATCH) {
+            *out++ = dist;
+        }
+
+        for (int k = 0; k < len; k++)
+            last[dump_hash(words[i + k])] = i + k;
+        i += len;
+        literal = i;
+    }
+
+    out = dump_emit_literal(out, words, literal, n);
+    return out - payload;
+}
+
+static void dump_flush_zero(uint64_t addr, uint32_t len, uint32_t *records)
+{
+    if (len == 0)
+        return;
+    print_uart_char('Z');
+    dump_put_u64(addr);
+    dump_put_u32(len);
+    (*records)++;
+}
+
+void dump_region(const void *addr, uint64_t len)
+{
+    uint64_t words[DUMP_BLOCK_WORDS];
+    // 最坏情况：每64个字多1个token字节
+    uint8_t payload[DUMP_BLOCK_BYTES + DUMP_BLOCK_WORDS / TOKEN_MAX_WORDS];
+    uintptr_t base = (uintptr_t)addr;
+    uint64_t zero_addr = base;
+    uint32_t zero_len = 0;
+    uint32_t records = 0;
+
+    print_uart_char(0x7F);
+    print_uart("DMP");
+    print_uart_char(DUMP_VERSION);
+    dump_put_u64(base);
+    dump_put_u64(len);
+
+    for (uint64_t off = 0; off < len; off += DUMP_BLOCK_BYTES) {
+        uint32_t raw_len = (len - off < DUMP_BLOCK_BYTES) ? (uint32_t)(len - off) : DUMP_BLOCK_BYTES;
+        int n = (raw_len + 7) / 8;
+
+        if (!dump_load_block(base + off, raw_len, words)) {
+            // 连续的全零块合并为一条'Z'记录
+            if (zero_len > 0xFFFFFFFFu - DUMP_BLOCK_BYTES) {
+                dump_flush_zero(zero_addr, zero_len, &records);
+                zero_len = 0;
+            }
+            if (zero_len == 0)
+                zero_addr = base + off;
+            zero_len += raw_len;
+            continue;
+        }
+
+        dump_flush_zero(zero_addr, zero_len, &records);
+        zero_len = 0;
+
+        uint32_t payload_len = dump_encode_block(words, n, payload);
+
+        print_uart_char('B');
+        dump_put_u64(base + off);
+        dump_put_u16(raw_len);
+        dump_put_u16(payload_len);
+        dump_put_bytes(payload, payload_len);
+        dump_put_u32(dump_checksum(words, n));
+        records++;
+    }
+
+    dump_flush_zero(zero_addr, zero_len, &records);
+
+    print_uart_char('E');
+    dump_put_u64(len);
+    dump_put_u32(records);
+}
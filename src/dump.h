@@ -0,0 +1,27 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Compressed Memory Dump over UART
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+// 数据流格式（小端）：
+//   头部:   0x7F 'D' 'M' 'P' | u8 version | u64 base | u64 len
+//   'B' 块: u64 addr | u16 raw_len | u16 payload_len | payload | u32 fnv
+//   'Z' 块: u64 addr | u32 len                       (全零区域，不含数据)
+//   'E' 尾: u64 total_len | u32 records
+//
+// payload 以64位字为单位编码，token 低6位为 n-1（n = 1..64 个字）：
+//   0x00 | n-1 : n 个原始字
+//   0x40 | n-1 : 后随的一个字重复 n 次
+//   0x80 | n-1 : n 个零字
+//   0xC0 | n-1 : 从 dist 个字之前复制 n 个字，后随 u8 dist
+// 接收端见 utils/dump_recv.py
+
+#define DUMP_VERSION      1
+#define DUMP_BLOCK_WORDS  128
+#define DUMP_BLOCK_BYTES  (DUMP_BLOCK_WORDS * 8)
+
+void dump_region(const void *addr, uint64_t len);
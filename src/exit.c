@@ -0,0 +1,56 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Program Exit Hooks (atexit / exit)
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "exit.h"
+#include <stddef.h>
+
+static void (*exit_hooks[EXIT_MAX_HOOKS])(void);
+static int exit_hook_count;
+static int exit_code;
+static void **exit_return_buf;
+
+int atexit(void (*fn)(void))
+{
+    if (exit_hook_count >= EXIT_MAX_HOOKS)
+        return -1;
+    exit_hooks[exit_hook_count++] = fn;
+    return 0;
+}
+
+// 覆盖 startup.S 中的弱定义；先取出再调用，钩子里再调用 exit() 也不会重入
+void run_exit_hooks(void)
+{
+    while (exit_hook_count > 0) {
+        void (*fn)(void) = exit_hooks[--exit_hook_count];
+        if (fn != NULL)
+            fn();
+    }
+}
+
+void exit(int status)
+{
+    exit_code = status;
+    run_exit_hooks();
+    if (exit_return_buf != NULL)
+        __builtin_longjmp(exit_return_buf, 1);
+    __asm__ volatile("j loop");
+    __builtin_unreachable();
+}
+
+int exit_status(void)
+{
+    return exit_code;
+}
+
+void exit_set_return(void **buf)
+{
+    exit_return_buf = buf;
+}
+
+void exit_reset(void)
+{
+    exit_hook_count = 0;
+    exit_code = 0;
+}
@@ -0,0 +1,28 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Program Exit Hooks (atexit / exit)
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#define EXIT_MAX_HOOKS 8
+
+// 注册在 main 返回或调用 exit() 时执行的函数，按注册的逆序执行
+// 返回 0 成功，-1 表示已满
+int atexit(void (*fn)(void));
+
+// 执行全部退出钩子（只执行一次），由 startup.S 在 main 返回后调用
+void run_exit_hooks(void);
+
+// 执行退出钩子后停在 startup.S 的 loop，不再返回；
+// 设置了 exit_set_return() 时改为 __builtin_longjmp 到该缓冲区
+void exit(int status) __attribute__((noreturn));
+
+// 最近一次 exit() 的参数；main 正常返回时为 0
+int exit_status(void);
+
+// 多程序镜像（menu.c）用：exit() 跳回 buf 指向的 __builtin_setjmp 缓冲区，NULL 恢复默认行为
+void exit_set_return(void **buf);
+
+// 清空已注册的钩子和退出码，每个程序启动前调用
+void exit_reset(void);
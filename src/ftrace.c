@@ -0,0 +1,108 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Function Entry/Exit Tracing (-finstrument-functions)
+//////////////////////////////////////////////////////////////////////////////////
+
+// make TRACE=1 时除排除列表（本文件、UART 驱动、csr.h）外的所有函数都会
+// 在入口和出口调用下面的钩子。钩子里只能用宏访问 CSR，不能调用任何
+// 可能被插桩的函数，否则会无限递归。
+
+#include "ftrace.h"
+#include "csr.h"
+#include "exit.h"
+#include "uart.h"
+#include <stdint.h>
+
+#define NO_TRACE __attribute__((no_instrument_function))
+
+static uint64_t ftrace_ring[FTRACE_RING_SIZE];
+static uint32_t ftrace_head;
+static uint64_t ftrace_total;
+static uint32_t ftrace_overhead;
+static volatile int ftrace_on;
+static int ftrace_exit_hooked;
+
+// 关中断写入，保证中断处理函数的记录不会插在一条记录中间
+static inline NO_TRACE void ftrace_put(uint64_t fn, uint64_t flag)
+{
+    uint64_t irq = clear_csr(mstatus, MSTATUS_MIE);
+    uint32_t cycle = (uint32_t)read_csr(mcycle);
+    ftrace_ring[ftrace_head] = ((fn | flag) << 32) | cycle;
+    ftrace_head = (ftrace_head + 1) % FTRACE_RING_SIZE;
+    ftrace_total++;
+    if (irq & MSTATUS_MIE)
+        set_csr(mstatus, MSTATUS_MIE);
+}
+
+NO_TRACE void __cyg_profile_func_enter(void *fn, void *call_site)
+{
+    (void)call_site;
+    if (ftrace_on)
+        ftrace_put((uint32_t)(uintptr_t)fn, 0);
+}
+
+NO_TRACE void __cyg_profile_func_exit(void *fn, void *call_site)
+{
+    (void)call_site;
+    if (ftrace_on)
+        ftrace_put((uint32_t)(uintptr_t)fn, FTRACE_EXIT_FLAG);
+}
+
+// 用一组空的 enter/exit 估计每次调用的插桩开销，之后清空缓冲区
+static NO_TRACE void ftrace_calibrate(void)
+{
+    const int n = 16;
+    uint64_t start = read_csr(mcycle);
+    for (int i = 0; i < n; i++) {
+        __cyg_profile_func_enter((void *)ftrace_calibrate, 0);
+        __cyg_profile_func_exit((void *)ftrace_calibrate, 0);
+    }
+    ftrace_overhead = (read_csr(mcycle) - start) / n;
+    ftrace_head = 0;
+    ftrace_total = 0;
+}
+
+NO_TRACE void ftrace_start(void)
+{
+    ftrace_on = 1;
+    ftrace_calibrate();
+    if (!ftrace_exit_hooked) {
+        ftrace_exit_hooked = 1;
+        atexit(ftrace_dump);
+    }
+}
+
+NO_TRACE void ftrace_stop(void)
+{
+    ftrace_on = 0;
+}
+
+NO_TRACE void ftrace_dump(void)
+{
+    int was_on = ftrace_on;
+    ftrace_on = 0;
+
+    uint32_t count = ftrace_total < FTRACE_RING_SIZE ? (uint32_t)ftrace_total : FTRACE_RING_SIZE;
+    uint32_t first = (ftrace_head + FTRACE_RING_SIZE - count) % FTRACE_RING_SIZE;
+
+    printf_uart("@FTRACE begin %u %lu %u\n", count, ftrace_total - count, ftrace_overhead);
+    for (uint32_t i = 0; i < count; i++) {
+        if (i % 4 == 0)
+            print_uart(i == 0 ? "@FTRACE r" : "\n@FTRACE r");
+        printf_uart(" %lx", ftrace_ring[(first + i) % FTRACE_RING_SIZE]);
+    }
+    if (count != 0)
+        print_uart("\n");
+    print_uart("@FTRACE end\n");
+
+    ftrace_on = was_on;
+}
+
+#ifdef FTRACE_AUTOSTART
+// make TRACE=1 时在 main 之前开始记录（由 startup.S 执行 .init_array）
+__attribute__((constructor))
+static NO_TRACE void ftrace_autostart(void)
+{
+    ftrace_start();
+}
+#endif
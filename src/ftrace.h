@@ -0,0 +1,33 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Function Entry/Exit Tracing (-finstrument-functions)
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+// 环形缓冲区记录数（每条 8 字节），写满后覆盖最旧的记录
+#ifndef FTRACE_RING_SIZE
+#define FTRACE_RING_SIZE 2048
+#endif
+
+// 每条记录：高 32 位为函数地址（bit0 = 1 表示退出），低 32 位为 mcycle 低 32 位。
+// 相邻记录间隔小于 2^32 个周期时，主机端可以还原完整时间。
+#define FTRACE_EXIT_FLAG 1ULL
+
+void ftrace_start(void);
+
+void ftrace_stop(void);
+
+// 通过 UART 输出 @FTRACE 记录，由 utils/ftrace_report.py 解析：
+//   @FTRACE begin <records> <lost> <overhead_cycles>
+//   @FTRACE r <record> <record> <record> <record>
+//   @FTRACE end
+// overhead_cycles 为一次 enter/exit 对自身的开销估计，供主机端扣除
+void ftrace_dump(void);
+
+// 编译器插入的钩子
+void __cyg_profile_func_enter(void *fn, void *call_site);
+
+void __cyg_profile_func_exit(void *fn, void *call_site);
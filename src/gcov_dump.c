@@ -0,0 +1,135 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Freestanding gcov Counter Dump over UART (make PGO=gen)
+//////////////////////////////////////////////////////////////////////////////////
+
+// 以 -fprofile-generate -fprofile-info-section 编译时，每个编译单元的 gcov_info
+// 指针放在 .gcov_info 段（linker.ld 中以 __gcov_info_start/__gcov_info_end 界定），
+// 不会生成依赖文件系统的 __gcov_init 构造函数。这里用 libgcov 的
+// __gcov_info_to_gcda 把计数器序列化成 .gcda 数据流，按十六进制逐行输出：
+//   @GCOV begin <编译单元数>
+//   @GCOV file <gcda 路径>
+//   @GCOV d <十六进制数据>
+//   @GCOV sum <字节数> <FNV-1a 校验>
+//   @GCOV end
+
+#include "gcov_dump.h"
+#include "exit.h"
+#include "mem.h"
+#include "uart.h"
+#include <gcov.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define NO_PROFILE __attribute__((no_profile_instrument_function))
+
+extern const struct gcov_info *const __gcov_info_start[];
+extern const struct gcov_info *const __gcov_info_end[];
+
+static uint8_t gcov_arena[GCOV_DUMP_ARENA_SIZE] __attribute__((aligned(16)));
+static uint32_t gcov_arena_used;
+
+static uint8_t gcov_line[GCOV_DUMP_LINE_BYTES];
+static uint32_t gcov_line_len;
+static uint32_t gcov_bytes;
+static uint32_t gcov_hash;
+
+static NO_PROFILE void gcov_flush_line(void)
+{
+    static const char hex[] = "0123456789abcdef";
+    if (gcov_line_len == 0)
+        return;
+    print_uart("@GCOV d ");
+    for (uint32_t i = 0; i < gcov_line_len; i++) {
+        print_uart_char(hex[gcov_line[i] >> 4]);
+        print_uart_char(hex[gcov_line[i] & 0xf]);
+    }
+    print_uart_char('\n');
+    gcov_line_len = 0;
+}
+
+static NO_PROFILE void gcov_dump_bytes(const void *data, unsigned length, void *arg)
+{
+    const uint8_t *p = data;
+    (void)arg;
+    for (unsigned i = 0; i < length; i++) {
+        gcov_line[gcov_line_len++] = p[i];
+        gcov_hash = (gcov_hash ^ p[i]) * 16777619u;
+        if (gcov_line_len == GCOV_DUMP_LINE_BYTES)
+            gcov_flush_line();
+    }
+    gcov_bytes += length;
+}
+
+static NO_PROFILE void gcov_dump_filename(const char *name, void *arg)
+{
+    (void)arg;
+    printf_uart("@GCOV file %s\n", name ? name : "unknown.gcda");
+}
+
+// 只分配不释放，每个编译单元输出完后整体回收
+static NO_PROFILE void *gcov_allocate(unsigned length, void *arg)
+{
+    (void)arg;
+    length = (length + 15) & ~15u;
+    if (gcov_arena_used + length > GCOV_DUMP_ARENA_SIZE)
+        return NULL;
+    void *p = &gcov_arena[gcov_arena_used];
+    gcov_arena_used += length;
+    memset(p, 0, length);
+    return p;
+}
+
+NO_PROFILE void gcov_dump(void)
+{
+    const struct gcov_info *const *info;
+
+    printf_uart("@GCOV begin %u\n", (uint32_t)(__gcov_info_end - __gcov_info_start));
+    for (info = __gcov_info_start; info < __gcov_info_end; info++) {
+        gcov_line_len = 0;
+        gcov_bytes = 0;
+        gcov_hash = 2166136261u;
+        gcov_arena_used = 0;
+        __gcov_info_to_gcda(*info, gcov_dump_filename, gcov_dump_bytes, gcov_allocate, NULL);
+        gcov_flush_line();
+        printf_uart("@GCOV sum %u %x\n", gcov_bytes, gcov_hash);
+    }
+    print_uart("@GCOV end\n");
+}
+
+// libgcov 中的合并函数只在读取已有 .gcda 时使用，这里永远不会调用；
+// 在此定义可避免链接进依赖 libc 文件操作的 libgcov 目标文件
+NO_PROFILE void __gcov_merge_add(int64_t *counters, unsigned n_counters)
+{
+    (void)counters;
+    (void)n_counters;
+}
+
+// __gcov_info_to_gcda 内部断言失败时调用
+NO_PROFILE void abort(void)
+{
+    print_uart("@GCOV abort\n");
+    exit(1);
+}
+
+// 带 newlib 的工具链中 libgcov 用 mmap 为 top-N 值剖析分配内存；
+// -fno-profile-values 下不会用到，弱定义只为满足链接
+__attribute__((weak)) NO_PROFILE void *mmap(void *addr, size_t length, int prot, int flags, int fd, long offset)
+{
+    (void)addr;
+    (void)length;
+    (void)prot;
+    (void)flags;
+    (void)fd;
+    (void)offset;
+    return (void *)-1;
+}
+
+#ifdef GCOV_DUMP_AUTO
+// make PGO=gen 时注册退出钩子（由 startup.S 执行 .init_array）
+__attribute__((constructor))
+static NO_PROFILE void gcov_dump_autostart(void)
+{
+    atexit(gcov_dump);
+}
+#endif
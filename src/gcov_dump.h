@@ -0,0 +1,18 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Freestanding gcov Counter Dump over UART (make PGO=gen)
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// __gcov_info_to_gcda 分配内存用的静态缓冲区大小（只有 top-N 值剖析会用到）
+#ifndef GCOV_DUMP_ARENA_SIZE
+#define GCOV_DUMP_ARENA_SIZE 4096
+#endif
+
+// 每行 @GCOV d 记录的字节数
+#define GCOV_DUMP_LINE_BYTES 32
+
+// 把 .gcov_info 段中所有编译单元的计数器按 .gcda 格式输出到 UART，
+// 由 utils/gcov_recv.py 还原成 .gcda 文件；make PGO=gen 时在程序退出时自动调用
+void gcov_dump(void);
@@ -0,0 +1,206 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Hardware Performance Monitor (mhpmevent/mhpmcounter3+)
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "hpm.h"
+#include "csr.h"
+#include "uart.h"
+#include <stdint.h>
+#include <stddef.h>
+
+static const char *const hpm_event_names[HPM_EV_COUNT] = {
+    [HPM_EV_NONE]           = "none",
+    [HPM_EV_L1I_MISS]       = "L1I_MISS",
+    [HPM_EV_L1D_MISS]       = "L1D_MISS",
+    [HPM_EV_ITLB_MISS]      = "ITLB_MISS",
+    [HPM_EV_DTLB_MISS]      = "DTLB_MISS",
+    [HPM_EV_LOAD]           = "LOAD",
+    [HPM_EV_STORE]          = "STORE",
+    [HPM_EV_BRANCH]         = "BRANCH",
+    [HPM_EV_BRANCH_MISS]    = "BRANCH_MISS",
+    [HPM_EV_L1I_ACCESS]     = "L1I_ACCESS",
+    [HPM_EV_L1D_ACCESS]     = "L1D_ACCESS",
+    [HPM_EV_L1I_STALL]      = "L1I_STALL",
+    [HPM_EV_L1D_STALL]      = "L1D_STALL",
+    [HPM_EV_LOAD_USE_STALL] = "LOAD_USE_STALL",
+    [HPM_EV_BUBBLE]         = "BUBBLE",
+};
+
+// mhpmevent 编码，0 表示该平台没有此事件
+#if defined(HPM_PLATFORM_CVA6)
+// CVA6 perf_counters：每个事件一个编号
+static const char hpm_platform[] = "CVA6";
+static const uint64_t hpm_event_codes[HPM_EV_COUNT] = {
+    [HPM_EV_L1I_MISS]       = 1,
+    [HPM_EV_L1D_MISS]       = 2,
+    [HPM_EV_ITLB_MISS]      = 3,
+    [HPM_EV_DTLB_MISS]      = 4,
+    [HPM_EV_LOAD]           = 5,
+    [HPM_EV_STORE]          = 6,
+    [HPM_EV_BRANCH]         = 9,
+    [HPM_EV_BRANCH_MISS]    = 10,
+    [HPM_EV_L1I_ACCESS]     = 16,
+    [HPM_EV_L1D_ACCESS]     = 17,
+    [HPM_EV_BUBBLE]         = 22,
+};
+#elif defined(HPM_PLATFORM_ROCKET)
+// Rocket：低 8 位为事件集，高位为事件掩码
+#define ROCKET_EVENT(set, bit) ((set) | (1ULL << (bit)))
+static const char hpm_platform[] = "Rocket";
+static const uint64_t hpm_event_codes[HPM_EV_COUNT] = {
+    [HPM_EV_LOAD]           = ROCKET_EVENT(0, 9),
+    [HPM_EV_STORE]          = ROCKET_EVENT(0, 10),
+    [HPM_EV_BRANCH]         = ROCKET_EVENT(0, 14),
+    [HPM_EV_LOAD_USE_STALL] = ROCKET_EVENT(1, 8),
+    [HPM_EV_L1I_STALL]      = ROCKET_EVENT(1, 11),
+    [HPM_EV_L1D_STALL]      = ROCKET_EVENT(1, 12),
+    [HPM_EV_BRANCH_MISS]    = ROCKET_EVENT(1, 13),
+    [HPM_EV_L1I_MISS]       = ROCKET_EVENT(2, 8),
+    [HPM_EV_L1D_MISS]       = ROCKET_EVENT(2, 9),
+    [HPM_EV_ITLB_MISS]      = ROCKET_EVENT(2, 11),
+    [HPM_EV_DTLB_MISS]      = ROCKET_EVENT(2, 12),
+};
+#endif
+
+// 当前配置，hpm_region_begin 时拷贝到区间结构中
+static hpm_event_t hpm_active[HPM_NUM_COUNTERS];
+static int hpm_active_count;
+
+// CSR 编号必须是立即数，只能逐个展开
+static void hpm_write_event(int idx, uint64_t code)
+{
+    switch (idx) {
+    case 0: write_csr(mhpmevent3, code); break;
+    case 1: write_csr(mhpmevent4, code); break;
+    case 2: write_csr(mhpmevent5, code); break;
+    case 3: write_csr(mhpmevent6, code); break;
+    case 4: write_csr(mhpmevent7, code); break;
+    case 5: write_csr(mhpmevent8, code); break;
+    case 6: write_csr(mhpmevent9, code); break;
+    case 7: write_csr(mhpmevent10, code); break;
+    }
+}
+
+static uint64_t hpm_read_counter(int idx)
+{
+    switch (idx) {
+    case 0: return read_csr(mhpmcounter3);
+    case 1: return read_csr(mhpmcounter4);
+    case 2: return read_csr(mhpmcounter5);
+    case 3: return read_csr(mhpmcounter6);
+    case 4: return read_csr(mhpmcounter7);
+    case 5: return read_csr(mhpmcounter8);
+    case 6: return read_csr(mhpmcounter9);
+    case 7: return read_csr(mhpmcounter10);
+    }
+    return 0;
+}
+
+const char *hpm_platform_name(void)
+{
+    return hpm_platform;
+}
+
+const char *hpm_event_name(hpm_event_t ev)
+{
+    return (ev >= 0 && ev < HPM_EV_COUNT) ? hpm_event_names[ev] : "?";
+}
+
+int hpm_event_supported(hpm_event_t ev)
+{
+    return ev > HPM_EV_NONE && ev < HPM_EV_COUNT && hpm_event_codes[ev] != 0;
+}
+
+int hpm_configure(const hpm_event_t *events, int n)
+{
+    int used = 0;
+    for (int i = 0; i < n && used < HPM_NUM_COUNTERS && used < 8; i++) {
+        if (!hpm_event_supported(events[i]))
+            continue;
+        hpm_write_event(used, hpm_event_codes[events[i]]);
+        hpm_active[used++] = events[i];
+    }
+    // 关闭剩余计数器
+    for (int i = used; i < HPM_NUM_COUNTERS && i < 8; i++)
+        hpm_write_event(i, 0);
+    hpm_active_count = used;
+    return used;
+}
+
+void hpm_region_begin(hpm_region_t *r)
+{
+    r->n = hpm_active_count;
+    for (int i = 0; i < r->n; i++) {
+        r->events[i] = hpm_active[i];
+        r->start[i] = hpm_read_counter(i);
+    }
+    r->instret0 = read_csr(minstret);
+    r->cycle0 = read_csr(mcycle);
+}
+
+void hpm_region_end(hpm_region_t *r)
+{
+    r->cycles = read_csr(mcycle) - r->cycle0;
+    r->instret = read_csr(minstret) - r->instret0;
+    for (int i = 0; i < r->n; i++)
+        r->value[i] = hpm_read_counter(i) - r->start[i];
+}
+
+int64_t hpm_region_get(const hpm_region_t *r, hpm_event_t ev)
+{
+    for (int i = 0; i < r->n; i++) {
+        if (r->events[i] == ev)
+            return (int64_t)r->value[i];
+    }
+    return -1;
+}
+
+// 以两位小数输出百分比 num / den
+static void hpm_print_percent(uint64_t num, uint64_t den)
+{
+    uint64_t bp = num * 10000 / den;
+    printf_uart("%lu.%u%u%%", bp / 100, (uint32_t)(bp / 10 % 10), (uint32_t)(bp % 10));
+}
+
+static void hpm_print_rate(const hpm_region_t *r, const char *label,
+                           hpm_event_t miss, hpm_event_t total, hpm_event_t total2)
+{
+    int64_t m = hpm_region_get(r, miss);
+    int64_t t = hpm_region_get(r, total);
+    // 没有 access 事件时用 load + store 作为分母
+    if (t < 0 && total2 != HPM_EV_NONE) {
+        int64_t t2 = hpm_region_get(r, total2);
+        int64_t t1 = hpm_region_get(r, HPM_EV_LOAD);
+        t = (t1 >= 0 && t2 >= 0) ? t1 + t2 : -1;
+    }
+    if (m < 0 || t <= 0)
+        return;
+    printf_uart("  %s: ", label);
+    hpm_print_percent(m, t);
+}
+
+void hpm_region_print(const char *name, const hpm_region_t *r)
+{
+    uint64_t cpi_milli = r->instret ? r->cycles * 1000 / r->instret : 0;
+    printf_uart("[%s] cycles: %lu, instret: %lu, CPI: %lu.%u%u%u\n", name, r->cycles, r->instret,
+                cpi_milli / 1000, (uint32_t)(cpi_milli / 100 % 10),
+                (uint32_t)(cpi_milli / 10 % 10), (uint32_t)(cpi_milli % 10));
+    if (r->n == 0)
+        return;
+
+    print_uart("       ");
+    for (int i = 0; i < r->n; i++)
+        printf_uart(" %s=%lu", hpm_event_name(r->events[i]), r->value[i]);
+    print_uart("\n       ");
+    hpm_print_rate(r, "L1D miss", HPM_EV_L1D_MISS, HPM_EV_L1D_ACCESS, HPM_EV_STORE);
+    hpm_print_rate(r, "L1I miss", HPM_EV_L1I_MISS, HPM_EV_L1I_ACCESS, HPM_EV_NONE);
+    hpm_print_rate(r, "branch miss", HPM_EV_BRANCH_MISS, HPM_EV_BRANCH, HPM_EV_NONE);
+    // 停顿周期占比，用来区分访存受限与计算受限
+    int64_t stall = hpm_region_get(r, HPM_EV_L1D_STALL);
+    if (stall >= 0 && r->cycles != 0) {
+        print_uart("  D$ stall: ");
+        hpm_print_percent(stall, r->cycles);
+    }
+    print_uart("\n");
+}
@@ -0,0 +1,71 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Hardware Performance Monitor (mhpmevent/mhpmcounter3+)
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+// 可编程计数器 mhpmcounter3 .. mhpmcounter(3+HPM_NUM_COUNTERS-1)
+// CVA6 默认实现 3..8 共 6 个，按实际内核用 -DHPM_NUM_COUNTERS=... 修改
+#ifndef HPM_NUM_COUNTERS
+#define HPM_NUM_COUNTERS 6
+#endif
+
+// 事件编码表的平台选择：默认 CVA6，-DHPM_PLATFORM_ROCKET 使用 Rocket 的事件集编码
+#if !defined(HPM_PLATFORM_CVA6) && !defined(HPM_PLATFORM_ROCKET)
+#define HPM_PLATFORM_CVA6
+#endif
+
+// 与平台无关的事件名，各平台的 mhpmevent 编码见 hpm.c 中的表
+typedef enum {
+    HPM_EV_NONE = 0,
+    HPM_EV_L1I_MISS,
+    HPM_EV_L1D_MISS,
+    HPM_EV_ITLB_MISS,
+    HPM_EV_DTLB_MISS,
+    HPM_EV_LOAD,
+    HPM_EV_STORE,
+    HPM_EV_BRANCH,
+    HPM_EV_BRANCH_MISS,
+    HPM_EV_L1I_ACCESS,
+    HPM_EV_L1D_ACCESS,
+    HPM_EV_L1I_STALL,
+    HPM_EV_L1D_STALL,
+    HPM_EV_LOAD_USE_STALL,
+    HPM_EV_BUBBLE,
+    HPM_EV_COUNT
+} hpm_event_t;
+
+typedef struct {
+    int         n;
+    hpm_event_t events[HPM_NUM_COUNTERS];
+    uint64_t    start[HPM_NUM_COUNTERS];
+    uint64_t    value[HPM_NUM_COUNTERS];
+    uint64_t    cycle0;
+    uint64_t    instret0;
+    uint64_t    cycles;
+    uint64_t    instret;
+} hpm_region_t;
+
+const char *hpm_platform_name(void);
+
+const char *hpm_event_name(hpm_event_t ev);
+
+// 当前平台是否有该事件
+int hpm_event_supported(hpm_event_t ev);
+
+// 依次把事件写入 mhpmevent3..，不支持的事件被跳过；返回实际配置的计数器数
+int hpm_configure(const hpm_event_t *events, int n);
+
+// 区间开始/结束，记录 mcycle/minstret 与已配置计数器的差值
+void hpm_region_begin(hpm_region_t *r);
+
+void hpm_region_end(hpm_region_t *r);
+
+// 取区间内某事件的计数，未配置时返回 -1
+int64_t hpm_region_get(const hpm_region_t *r, hpm_event_t ev);
+
+// 输出周期、CPI、各计数器，以及能算出的缺失率（L1D/L1I/分支预测）
+void hpm_region_print(const char *name, const hpm_region_t *r);
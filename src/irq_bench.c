@@ -0,0 +1,187 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Interrupt / Exception Latency Benchmark (CLINT software interrupt)
+//////////////////////////////////////////////////////////////////////////////////
+
+// 用 CLINT msip 触发机器软件中断，测量三种进入方式的开销：
+//   direct   : 直接模式，trap_entry 保存全部寄存器后经 handle_trap 调用处理函数
+//   vectored : 向量模式但只注册了普通处理函数，先进 irq_soft_entry 再转入完整路径
+//   fast     : 向量模式 + register_fast_irq_handler，只保存调用者保存寄存器
+// 另外用非法指令测量异常路径。每次测量：
+//   entry  = 处理函数第一条 mcycle - 触发前的 mcycle
+//   return = 回到主程序后的 mcycle - 处理函数最后一条 mcycle
+//
+// make MAIN=irq_bench
+
+#include <stdint.h>
+#include "bench.h"
+#include "csr.h"
+#include "platform.h"
+#include "result.h"
+#include "timer.h"
+#include "trap.h"
+#include "uart.h"
+
+#ifndef IRQ_BENCH_ITERS
+#define IRQ_BENCH_ITERS 100
+#endif
+
+// 触发后超过该周期数仍未进入处理函数视为失败
+#define IRQ_BENCH_TIMEOUT_CYCLES 100000
+
+typedef struct {
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+} lat_t;
+
+static volatile uint32_t *msip;
+static volatile uint64_t t_entry;
+static volatile uint64_t t_exit;
+static volatile uint32_t irq_seen;
+
+static void lat_add(lat_t *l, uint64_t cycles)
+{
+    l->sum += cycles;
+    if (cycles < l->min)
+        l->min = cycles;
+    if (cycles > l->max)
+        l->max = cycles;
+}
+
+static void soft_fast(void)
+{
+    t_entry = read_mcycle();
+    *msip = 0;
+    irq_seen = 1;
+    t_exit = read_mcycle();
+}
+
+static void soft_full(trap_frame_t *tf)
+{
+    (void)tf;
+    t_entry = read_mcycle();
+    *msip = 0;
+    irq_seen = 1;
+    t_exit = read_mcycle();
+}
+
+static void illegal_skip(trap_frame_t *tf)
+{
+    t_entry = read_mcycle();
+    tf->mepc += 4;
+    irq_seen = 1;
+    t_exit = read_mcycle();
+}
+
+static void illegal_dump(trap_frame_t *tf)
+{
+    trap_dump(tf);
+    tf->mepc += 4;
+}
+
+static void emit(const char *cfg, const char *what, uint64_t cycles, uint64_t instret, int errors)
+{
+    char test[32];
+    int n = 0;
+    for (const char *p = cfg; *p; p++)
+        test[n++] = *p;
+    test[n++] = '.';
+    for (const char *p = what; *p; p++)
+        test[n++] = *p;
+    test[n] = '\0';
+    result_emit(test, cycles, instret, 0, errors);
+}
+
+// exception 为 0 时写 msip 触发软件中断，否则执行一条非法指令
+static int measure(const char *cfg, int exception)
+{
+    lat_t entry = {0, UINT64_MAX, 0};
+    lat_t ret = {0, UINT64_MAX, 0};
+    uint64_t total = 0, instret = 0;
+    int errors = 0;
+
+    for (int i = 0; i < IRQ_BENCH_ITERS; i++) {
+        irq_seen = 0;
+        uint64_t i0 = read_minstret();
+        uint64_t t0 = read_mcycle();
+        if (exception)
+            __asm__ volatile (".4byte 0" ::: "memory");
+        else
+            *msip = 1;
+        while (!irq_seen) {
+            if (read_mcycle() - t0 > IRQ_BENCH_TIMEOUT_CYCLES)
+                break;
+        }
+        uint64_t t1 = read_mcycle();
+        uint64_t i1 = read_minstret();
+        if (!irq_seen) {
+            *msip = 0;
+            errors++;
+            continue;
+        }
+        lat_add(&entry, t_entry - t0);
+        lat_add(&ret, t1 - t_exit);
+        total += t1 - t0;
+        instret += i1 - i0;
+    }
+
+    int n = IRQ_BENCH_ITERS - errors;
+    if (n == 0) {
+        printf_uart("[%s] no interrupt taken, FAIL\n", cfg);
+        emit(cfg, "total", 0, 0, errors);
+        return errors;
+    }
+    printf_uart("[%s] entry avg: %lu (min %lu, max %lu), return avg: %lu (min %lu, max %lu), "
+                "round trip: %lu cycles / %lu insns, %s\n",
+                cfg, entry.sum / n, entry.min, entry.max, ret.sum / n, ret.min, ret.max,
+                total / n, instret / n, errors == 0 ? "PASS" : "FAIL");
+    emit(cfg, "entry", entry.sum / n, 0, errors);
+    emit(cfg, "return", ret.sum / n, 0, errors);
+    emit(cfg, "total", total / n, instret / n, errors);
+    return errors;
+}
+
+int main()
+{
+    int errors = 0;
+
+    if (init_uart(PLAT_CLK_FREQ, PLAT_UART_BAUD) != 0)
+        return 1;
+    bench_header("Interrupt Latency Benchmark");
+    printf_uart("%d interrupts per configuration\n\n", IRQ_BENCH_ITERS);
+
+    msip = (volatile uint32_t *)CLINT_MSIP(read_mhartid());
+    *msip = 0;
+    register_irq_handler(IRQ_M_SOFT, soft_full);
+    enable_irq(IRQ_M_SOFT);
+    enable_interrupts();
+
+    trap_set_mode(TRAP_MODE_DIRECT);
+    errors += measure("direct", 0);
+
+    trap_set_mode(TRAP_MODE_VECTORED);
+    errors += measure("vectored", 0);
+
+    register_fast_irq_handler(IRQ_M_SOFT, soft_fast);
+    errors += measure("fast", 0);
+    register_fast_irq_handler(IRQ_M_SOFT, NULL);
+
+    disable_irq(IRQ_M_SOFT);
+    register_irq_handler(IRQ_M_SOFT, NULL);
+
+    register_exception_handler(EXC_ILLEGAL, illegal_skip);
+    errors += measure("exception", 1);
+
+    // 未注册处理函数时崩溃输出的格式
+    print_uart("\nException dump (illegal instruction, skipped):");
+    register_exception_handler(EXC_ILLEGAL, illegal_dump);
+    __asm__ volatile (".4byte 0" ::: "memory");
+    register_exception_handler(EXC_ILLEGAL, NULL);
+
+    if (errors == 0)
+        print_uart("\nAll interrupt tests passed\n");
+    else
+        printf_uart("\nInterrupt self-check failed: %d error(s)\n", errors);
+    return 0;
+}
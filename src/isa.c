@@ -0,0 +1,470 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Runtime ISA Feature Detection and Kernel Dispatch
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "isa.h"
+#include "csr.h"
+#include "uart.h"
+#include <stdint.h>
+#include <stddef.h>
+
+// 本文件中的循环不能再被识别成 memset 调用
+#pragma GCC optimize("no-tree-loop-distribute-patterns")
+
+////////////////////////////////////////////////////////////////////////////////
+// 检测
+////////////////////////////////////////////////////////////////////////////////
+
+// 执行一条指令，触发非法指令异常时返回 0：临时把 mtvec（直接模式）指向本段代码中的
+// 恢复点，异常直接跳过去，不经过 trap.c。期间关中断。
+// 第一次调用可能发生在中断处理函数中，异常改写的 mepc/mcause/mtval 和 mstatus.MPIE/MPP
+// 都要恢复，否则外层 trap 返回到错误的位置。试探的指令都写 x0，不改变任何寄存器
+#define ISA_PROBE(insn) ({ \
+    uint64_t __ok, __tvec; \
+    uint64_t __epc = read_csr(mepc), __cause = read_csr(mcause), __tval = read_csr(mtval); \
+    uint64_t __status = clear_csr(mstatus, MSTATUS_MIE); \
+    __asm__ volatile( \
+        "la %1, 1f\n" \
+        "csrrw %1, mtvec, %1\n" \
+        "li %0, 1\n" \
+        insn "\n" \
+        "j 2f\n" \
+        ".balign 4\n" \
+        "1: li %0, 0\n" \
+        "2: csrw mtvec, %1\n" \
+        : "=&r"(__ok), "=&r"(__tvec) : : "memory"); \
+    write_csr(mepc, __epc); \
+    write_csr(mcause, __cause); \
+    write_csr(mtval, __tval); \
+    write_csr(mstatus, __status); \
+    __ok; })
+
+#define INSN_SH1ADD_ZERO    ".insn r 0x33, 2, 0x10, zero, zero, zero"
+#define INSN_CLZ_ZERO       ".insn i 0x13, 1, zero, zero, 0x600"
+#define INSN_CLMUL_ZERO     ".insn r 0x33, 1, 0x05, zero, zero, zero"
+#define INSN_BSET_ZERO      ".insn r 0x33, 1, 0x14, zero, zero, zero"
+
+static isa_info_t info;
+static int isa_detected;
+
+static void isa_detect(void)
+{
+    info.misa = read_csr(misa);
+    info.mvendorid = read_csr(mvendorid);
+    info.marchid = read_csr(marchid);
+    info.mimpid = read_csr(mimpid);
+
+    uint32_t f = 0;
+    if (info.misa & MISA_EXT('C'))
+        f |= ISA_C;
+#ifdef ISA_VECTOR
+    // misa 读为 0（未实现）时无法判断 V，向量指令在 VS 为 Off 时也会报非法指令，不做试探
+    if (info.misa & MISA_EXT('V')) {
+        if ((read_csr(mstatus) & MSTATUS_VS) == 0)
+            set_csr(mstatus, MSTATUS_VS_INIT);
+        f |= ISA_V;
+    }
+#endif
+    // B = Zba + Zbb + Zbs；没有 B 位的核（B 位批准之前的实现）逐个试探
+    if (info.misa & MISA_EXT('B')) {
+        f |= ISA_ZBA | ISA_ZBB | ISA_ZBS;
+    } else {
+        if (ISA_PROBE(INSN_SH1ADD_ZERO))
+            f |= ISA_ZBA;
+        if (ISA_PROBE(INSN_CLZ_ZERO))
+            f |= ISA_ZBB;
+        if (ISA_PROBE(INSN_BSET_ZERO))
+            f |= ISA_ZBS;
+    }
+    if (ISA_PROBE(INSN_CLMUL_ZERO))
+        f |= ISA_ZBC;
+    info.detected = f;
+    isa_detected = 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Zbb / Zbc 指令（.insn 编码，不需要 -march 支持）
+////////////////////////////////////////////////////////////////////////////////
+
+static inline uint64_t zbb_clz(uint64_t x)
+{
+    uint64_t r;
+    __asm__(".insn i 0x13, 1, %0, %1, 0x600" : "=r"(r) : "r"(x));
+    return r;
+}
+
+static inline uint64_t zbb_ctz(uint64_t x)
+{
+    uint64_t r;
+    __asm__(".insn i 0x13, 1, %0, %1, 0x601" : "=r"(r) : "r"(x));
+    return r;
+}
+
+static inline uint64_t zbc_clmul(uint64_t a, uint64_t b)
+{
+    uint64_t r;
+    __asm__(".insn r 0x33, 1, 0x05, %0, %1, %2" : "=r"(r) : "r"(a), "r"(b));
+    return r;
+}
+
+static inline uint64_t zbc_clmulr(uint64_t a, uint64_t b)
+{
+    uint64_t r;
+    __asm__(".insn r 0x33, 2, 0x05, %0, %1, %2" : "=r"(r) : "r"(a), "r"(b));
+    return r;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// fill / compare
+////////////////////////////////////////////////////////////////////////////////
+
+static void *fill_scalar(void *dst, int c, size_t n)
+{
+    uint8_t *d = dst;
+    uint64_t v = (uint8_t)c * 0x0101010101010101ULL;
+
+    for (; n && ((uintptr_t)d & 7); n--)
+        *d++ = (uint8_t)c;
+    for (; n >= 32; n -= 32, d += 32) {
+        ((uint64_t *)d)[0] = v;
+        ((uint64_t *)d)[1] = v;
+        ((uint64_t *)d)[2] = v;
+        ((uint64_t *)d)[3] = v;
+    }
+    for (; n >= 8; n -= 8, d += 8)
+        *(uint64_t *)d = v;
+    while (n--)
+        *d++ = (uint8_t)c;
+    return dst;
+}
+
+// 两端同为 8 字节对齐时按双字比较，遇到不等的双字后逐字节找出第一个不同的字节
+static int compare_scalar(const void *a, const void *b, size_t n)
+{
+    const uint8_t *p = a;
+    const uint8_t *q = b;
+
+    if ((((uintptr_t)p | (uintptr_t)q) & 7) == 0) {
+        for (; n >= 8; n -= 8, p += 8, q += 8) {
+            if (*(const uint64_t *)p != *(const uint64_t *)q)
+                break;
+        }
+    }
+    for (; n > 0; n--, p++, q++) {
+        if (*p != *q)
+            return *p - *q;
+    }
+    return 0;
+}
+
+// 小端：异或结果的最低非零字节就是第一个不同的字节，ctz 直接给出位置
+static int compare_zbb(const void *a, const void *b, size_t n)
+{
+    const uint8_t *p = a;
+    const uint8_t *q = b;
+
+    if ((((uintptr_t)p | (uintptr_t)q) & 7) == 0) {
+        for (; n >= 8; n -= 8, p += 8, q += 8) {
+            uint64_t x = *(const uint64_t *)p;
+            uint64_t y = *(const uint64_t *)q;
+            if (x != y) {
+                uint64_t shift = zbb_ctz(x ^ y) & ~7ULL;
+                return (int)((x >> shift) & 0xff) - (int)((y >> shift) & 0xff);
+            }
+        }
+    }
+    for (; n > 0; n--, p++, q++) {
+        if (*p != *q)
+            return *p - *q;
+    }
+    return 0;
+}
+
+#ifdef ISA_VECTOR
+// RVV 1.0，e8/m8；与 src/memkern.c 一样用 .option arch 临时打开 V
+#ifdef __riscv_vector
+#define ISA_VREGS , "v0", "v8", "v9", "v10", "v11", "v12", "v13", "v14", "v15", \
+    "v16", "v17", "v18", "v19", "v20", "v21", "v22", "v23", "vl", "vtype"
+#else
+#define ISA_VREGS
+#endif
+
+#define RVV_BEGIN ".option push\n.option arch, +v\n"
+#define RVV_END   ".option pop\n"
+
+static void *fill_rvv(void *dst, int c, size_t n)
+{
+    uint8_t *d = dst;
+    if (n == 0)
+        return dst;
+    __asm__ volatile(
+        RVV_BEGIN
+        "vsetvli t0, zero, e8, m8, ta, ma\n"
+        "vmv.v.x v8, %[c]\n"
+        "1:\n"
+        "vsetvli t0, %[n], e8, m8, ta, ma\n"
+        "vse8.v v8, (%[d])\n"
+        "sub %[n], %[n], t0\n"
+        "add %[d], %[d], t0\n"
+        "bnez %[n], 1b\n"
+        RVV_END
+        : [d] "+r"(d), [n] "+r"(n)
+        : [c] "r"(c)
+        : "t0", "memory" ISA_VREGS);
+    return dst;
+}
+
+// vmsne 得到不相等掩码，vfirst 给出第一个置位元素，没有时为 -1
+static int compare_rvv(const void *a, const void *b, size_t n)
+{
+    const uint8_t *p = a;
+    const uint8_t *q = b;
+    size_t idx = 0;
+    long first = -1;
+    if (n == 0)
+        return 0;
+    __asm__ volatile(
+        RVV_BEGIN
+        "1:\n"
+        "vsetvli t0, %[n], e8, m8, ta, ma\n"
+        "vle8.v v8, (%[p])\n"
+        "vle8.v v16, (%[q])\n"
+        "vmsne.vv v0, v8, v16\n"
+        "vfirst.m %[first], v0\n"
+        "bgez %[first], 2f\n"
+        "sub %[n], %[n], t0\n"
+        "add %[idx], %[idx], t0\n"
+        "add %[p], %[p], t0\n"
+        "add %[q], %[q], t0\n"
+        "bnez %[n], 1b\n"
+        "2:\n"
+        RVV_END
+        : [p] "+r"(p), [q] "+r"(q), [n] "+r"(n), [idx] "+r"(idx), [first] "+r"(first)
+        :
+        : "t0", "memory" ISA_VREGS);
+    if (first < 0)
+        return 0;
+    return ((const uint8_t *)a)[idx + first] - ((const uint8_t *)b)[idx + first];
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// CRC32（IEEE 802.3，反射多项式）
+////////////////////////////////////////////////////////////////////////////////
+
+#define CRC32_POLY      0xEDB88320u
+// floor(x^96 / P(x)) 的反射形式，用于 64 位一步的 Barrett 约简
+#define CRC32_POLY_QT   0x5a72d812fb808b20ULL
+
+static uint32_t crc_table[256];
+
+static void crc_table_init(void)
+{
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++)
+            c = (c & 1) ? (c >> 1) ^ CRC32_POLY : c >> 1;
+        crc_table[i] = c;
+    }
+}
+
+static uint32_t crc_bytes(uint32_t crc, const uint8_t *p, size_t n)
+{
+    while (n--)
+        crc = crc_table[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    return crc;
+}
+
+static uint32_t crc32_table(uint32_t crc, const void *data, size_t n)
+{
+    if (crc_table[1] == 0)
+        crc_table_init();
+    return ~crc_bytes(~crc, data, n);
+}
+
+// 每次处理 8 字节：s = crc ^ 数据，商 q = s * QT 的高位，余数 = (s ^ q * P) 的高 32 位；
+// 反射域中用 clmul + slli 代替 clmulrh，再用 clmulr 乘 P
+static uint32_t crc32_zbc(uint32_t crc, const void *data, size_t n)
+{
+    const uint8_t *p = data;
+    uint64_t poly = (uint64_t)CRC32_POLY << 32;
+
+    if (crc_table[1] == 0)
+        crc_table_init();
+    crc = ~crc;
+    size_t head = -(uintptr_t)p & 7;
+    if (head > n)
+        head = n;
+    crc = crc_bytes(crc, p, head);
+    p += head;
+    n -= head;
+    for (; n >= 8; n -= 8, p += 8) {
+        uint64_t s = crc ^ *(const uint64_t *)p;
+        uint64_t t = (zbc_clmul(s, CRC32_POLY_QT) << 1) ^ s;
+        crc = zbc_clmulr(t, poly) >> 32;
+    }
+    return ~crc_bytes(crc, p, n);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// 十进制转换：每次除以 100，两位一起查表
+////////////////////////////////////////////////////////////////////////////////
+
+static const char digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static const uint64_t pow10_table[20] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+    10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL};
+
+// 已知位数时从个位向前写，不需要倒序
+static int utoa_write(uint64_t value, char *buf, int digits)
+{
+    char *p = buf + digits;
+    *p = '\0';
+    while (value >= 100) {
+        uint64_t i = (value % 100) * 2;
+        value /= 100;
+        *--p = digit_pairs[i + 1];
+        *--p = digit_pairs[i];
+    }
+    if (value >= 10) {
+        *--p = digit_pairs[value * 2 + 1];
+        *--p = digit_pairs[value * 2];
+    } else {
+        *--p = '0' + value;
+    }
+    return digits;
+}
+
+static int utoa_scalar(uint64_t value, char *buf)
+{
+    int digits = 1;
+    while (digits < 20 && value >= pow10_table[digits])
+        digits++;
+    return utoa_write(value, buf, digits);
+}
+
+// 位数由最高有效位估计：log10(2) ~ 1233 / 4096，再与 10 的幂比较修正一次
+static int utoa_zbb(uint64_t value, char *buf)
+{
+    int t = ((64 - (int)zbb_clz(value | 1)) * 1233) >> 12;
+    int digits = t + 1 - (value < pow10_table[t]);
+    return utoa_write(value, buf, digits ? digits : 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// 绑定
+////////////////////////////////////////////////////////////////////////////////
+
+// 初始入口：第一次调用时检测并按默认绑定，之后经 isa_ops 转到绑定的实现
+static void *fill_lazy(void *dst, int c, size_t n)
+{
+    isa_init();
+    return isa_ops.fill(dst, c, n);
+}
+
+static int compare_lazy(const void *a, const void *b, size_t n)
+{
+    isa_init();
+    return isa_ops.compare(a, b, n);
+}
+
+static uint32_t crc32_lazy(uint32_t crc, const void *data, size_t n)
+{
+    isa_init();
+    return isa_ops.crc32(crc, data, n);
+}
+
+static int utoa_lazy(uint64_t value, char *buf)
+{
+    isa_init();
+    return isa_ops.utoa(value, buf);
+}
+
+isa_ops_t isa_ops = {
+    fill_lazy, compare_lazy, crc32_lazy, utoa_lazy,
+    "lazy", "lazy", "lazy", "lazy",
+};
+
+uint32_t isa_bind(uint32_t features)
+{
+    if (!isa_detected)
+        isa_detect();
+    uint32_t f = features & info.detected;
+    isa_ops_t ops = {
+        fill_scalar, compare_scalar, crc32_table, utoa_scalar,
+        "scalar", "scalar", "table", "scalar",
+    };
+
+    if (f & ISA_ZBB) {
+        ops.compare = compare_zbb;
+        ops.compare_impl = "zbb";
+        ops.utoa = utoa_zbb;
+        ops.utoa_impl = "zbb";
+    }
+    if (f & ISA_ZBC) {
+        ops.crc32 = crc32_zbc;
+        ops.crc32_impl = "zbc";
+    }
+#ifdef ISA_VECTOR
+    if (f & ISA_V) {
+        ops.fill = fill_rvv;
+        ops.fill_impl = "rvv";
+        ops.compare = compare_rvv;
+        ops.compare_impl = "rvv";
+    }
+#endif
+    isa_ops = ops;
+    info.bound = f;
+    return f;
+}
+
+void isa_init(void)
+{
+    isa_bind(ISA_ALL);
+}
+
+const isa_info_t *isa_info(void)
+{
+    if (!isa_detected)
+        isa_init();
+    return &info;
+}
+
+int isa_has(uint32_t mask)
+{
+    return (isa_info()->detected & mask) == mask;
+}
+
+void isa_report(void)
+{
+    // misa 中的单字母扩展按 ISA 字符串的规范顺序输出
+    static const char order[] = "IEMAFDQCBPVH";
+    static const struct { uint32_t bit; const char *name; } multi[] = {
+        {ISA_ZBA, "_zba"}, {ISA_ZBB, "_zbb"}, {ISA_ZBC, "_zbc"}, {ISA_ZBS, "_zbs"},
+    };
+    const isa_info_t *i = isa_info();
+    uint64_t mxl = i->misa >> 62;
+
+    printf_uart("ISA: rv%d", mxl == 1 ? 32 : mxl == 3 ? 128 : 64);
+    for (const char *c = order; *c; c++) {
+        if (i->misa & MISA_EXT(*c))
+            print_uart_char(*c + ('a' - 'A'));
+    }
+    if (i->misa == 0)
+        print_uart("?");
+    for (unsigned k = 0; k < sizeof(multi) / sizeof(multi[0]); k++) {
+        if (i->detected & multi[k].bit)
+            print_uart(multi[k].name);
+    }
+    printf_uart(" (misa 0x%lx)\n", i->misa);
+    printf_uart("mvendorid 0x%lx, marchid 0x%lx, mimpid 0x%lx\n", i->mvendorid, i->marchid, i->mimpid);
+    printf_uart("dispatch: fill=%s compare=%s crc32=%s utoa=%s\n",
+                isa_ops.fill_impl, isa_ops.compare_impl, isa_ops.crc32_impl, isa_ops.utoa_impl);
+}
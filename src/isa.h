@@ -0,0 +1,85 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Runtime ISA Feature Detection and Kernel Dispatch
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 同一个镜像在不同核上运行：第一次使用时读 misa 等 CSR，misa 不能反映的扩展
+// （Zbc，以及没有 B 位时的 Zba/Zbb/Zbs）执行一条该扩展的指令试探，按结果把
+// isa_ops 中的函数指针绑定到可用的最快实现。所有实现都只用 .insn 或
+// .option arch 临时打开扩展，编译用的 -march 保持 rv64im，基础核上始终使用标量实现。
+// RVV 实现需 make VECTOR=1 编入（与 src/memkern.c 相同），
+// 向量寄存器不在 trap_entry 保存的范围内，中断处理函数中不要调用 isa_fill/isa_compare。
+
+#define ISA_C       (1u << 0)
+#define ISA_V       (1u << 1)
+#define ISA_ZBA     (1u << 2)
+#define ISA_ZBB     (1u << 3)
+#define ISA_ZBC     (1u << 4)
+#define ISA_ZBS     (1u << 5)
+#define ISA_ALL     0xffffffffu
+
+typedef struct {
+    uint64_t misa;
+    uint64_t mvendorid;
+    uint64_t marchid;
+    uint64_t mimpid;
+    uint32_t detected;      // 核支持的 ISA_* 特性
+    uint32_t bound;         // isa_ops 当前使用的特性（isa_bind 可以限制）
+} isa_info_t;
+
+typedef struct {
+    void *(*fill)(void *dst, int c, size_t n);
+    int (*compare)(const void *a, const void *b, size_t n);
+    // 与 zlib crc32() 相同：crc 传 0 开始，分段计算时传入上一段的结果
+    uint32_t (*crc32)(uint32_t crc, const void *data, size_t n);
+    // 十进制输出到 buf（至少 21 字节，含结尾 '\0'），返回位数
+    int (*utoa)(uint64_t value, char *buf);
+    const char *fill_impl;
+    const char *compare_impl;
+    const char *crc32_impl;
+    const char *utoa_impl;
+} isa_ops_t;
+
+// 初始值为 "lazy" 入口，第一次调用任一函数（或 isa_info/isa_has/isa_report）时
+// 检测并按默认绑定，不使用的程序不做任何试探
+extern isa_ops_t isa_ops;
+
+// 检测并按默认绑定，重复调用只重新绑定；需要固定检测时机（如开中断或启动从核之前）时显式调用
+void isa_init(void);
+
+const isa_info_t *isa_info(void);
+
+// mask 中的特性是否全部支持
+int isa_has(uint32_t mask);
+
+// 只使用 features 与检测结果的交集重新绑定，返回实际使用的特性；
+// isa_bind(0) 为基础 rv64im 实现，isa_bind(ISA_ALL) 恢复默认
+uint32_t isa_bind(uint32_t features);
+
+// 输出 ISA 字符串、厂商/架构/实现编号和每个函数绑定的实现
+void isa_report(void);
+
+static inline void *isa_fill(void *dst, int c, size_t n)
+{
+    return isa_ops.fill(dst, c, n);
+}
+
+static inline int isa_compare(const void *a, const void *b, size_t n)
+{
+    return isa_ops.compare(a, b, n);
+}
+
+static inline uint32_t isa_crc32(uint32_t crc, const void *data, size_t n)
+{
+    return isa_ops.crc32(crc, data, n);
+}
+
+static inline int isa_utoa(uint64_t value, char *buf)
+{
+    return isa_ops.utoa(value, buf);
+}
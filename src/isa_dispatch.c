@@ -0,0 +1,199 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     ISA Dispatch Report: Detected Extensions and Per-Kernel Speedup
+//////////////////////////////////////////////////////////////////////////////////
+
+// 输出 isa_init() 检测到的扩展和每个函数绑定的实现，然后对 fill / compare / crc32 / utoa
+// 分别用基础实现（isa_bind(0)）和默认绑定计时，并检查两者结果一致。
+// 默认绑定与基础实现相同的函数只输出一次。
+//
+// make MAIN=isa_dispatch
+// make sim MAIN=isa_dispatch SIM_FLAGS="--ext zbb,zbc"
+
+#include <stdint.h>
+#include "bench.h"
+#include "isa.h"
+#include "platform.h"
+#include "result.h"
+#include "uart.h"
+
+#ifndef ISA_REPEAT
+#define ISA_REPEAT      8
+#endif
+
+#define ISA_BUF_LEN     4096
+#define UTOA_COUNT      256
+
+#define CRC32_CHECK_VALUE 0xCBF43926    // CRC32("123456789")
+
+static uint8_t  buf_a[ISA_BUF_LEN] __attribute__((aligned(64)));
+static uint8_t  buf_b[ISA_BUF_LEN] __attribute__((aligned(64)));
+static uint64_t utoa_values[UTOA_COUNT];
+
+typedef struct {
+    const char *name;
+    uint64_t bytes;                 // 每次调用处理的字节数，0 为不适用
+    uint64_t (*run)(void);          // 执行一次，返回用于比较的结果
+    const char *(*impl)(void);
+} isa_kernel_t;
+
+static uint64_t run_fill(void)
+{
+    uint64_t sum = 0;
+    isa_fill(buf_a + 3, 0x5a, ISA_BUF_LEN - 3);
+    for (int i = 0; i < ISA_BUF_LEN; i += 61)
+        sum += buf_a[i];
+    return sum;
+}
+
+// buf_a 与 buf_b 只有最后一个字节不同，比较整个缓冲区
+static uint64_t run_compare(void)
+{
+    return (uint64_t)(int64_t)isa_compare(buf_a, buf_b, ISA_BUF_LEN);
+}
+
+static uint64_t run_crc32(void)
+{
+    return isa_crc32(0, buf_a + 1, ISA_BUF_LEN - 1);
+}
+
+static uint64_t run_utoa(void)
+{
+    char text[21];
+    uint64_t sum = 0;
+    for (int i = 0; i < UTOA_COUNT; i++) {
+        int n = isa_utoa(utoa_values[i], text);
+        sum = sum * 31 + n + text[0] + text[n - 1];
+    }
+    return sum;
+}
+
+static const char *impl_fill(void)    { return isa_ops.fill_impl; }
+static const char *impl_compare(void) { return isa_ops.compare_impl; }
+static const char *impl_crc32(void)   { return isa_ops.crc32_impl; }
+static const char *impl_utoa(void)    { return isa_ops.utoa_impl; }
+
+static const isa_kernel_t kernels[] = {
+    {"fill",    ISA_BUF_LEN - 3, run_fill,    impl_fill},
+    {"compare", ISA_BUF_LEN,     run_compare, impl_compare},
+    {"crc32",   ISA_BUF_LEN - 1, run_crc32,   impl_crc32},
+    {"utoa",    0,               run_utoa,    impl_utoa},
+};
+
+static int same_name(const char *a, const char *b)
+{
+    while (*a && *a == *b) {
+        a++;
+        b++;
+    }
+    return *a == *b;
+}
+
+static void prepare(void)
+{
+    uint32_t seed = 0x1badb002;
+    for (int i = 0; i < ISA_BUF_LEN; i++)
+        buf_a[i] = buf_b[i] = bench_rand(&seed);
+    buf_b[ISA_BUF_LEN - 1] ^= 0x80;
+    for (int i = 0; i < UTOA_COUNT; i++) {
+        uint64_t v = ((uint64_t)bench_rand(&seed) << 32) | bench_rand(&seed);
+        // 覆盖 1 到 20 位的所有长度
+        utoa_values[i] = v >> (i % 64);
+    }
+}
+
+static uint64_t measure(const isa_kernel_t *k, bench_t *b)
+{
+    uint64_t result = 0;
+    // 先运行一次，让代码和数据进入缓存
+    k->run();
+    bench_start(b);
+    for (int r = 0; r < ISA_REPEAT; r++)
+        result = k->run();
+    bench_stop(b);
+    // fill 会改写 buf_a，恢复后 compare/crc32 的输入不变
+    prepare();
+    return result;
+}
+
+// 测试名为 <函数>.<实现>，如 crc32.table / crc32.zbc
+static void report(const isa_kernel_t *k, const char *impl, const bench_t *b, uint64_t base_cycles, int errors)
+{
+    char test[32];
+    int n = 0;
+    for (const char *p = k->name; *p; p++)
+        test[n++] = *p;
+    test[n++] = '.';
+    for (const char *p = impl; *p && n < (int)sizeof(test) - 1; p++)
+        test[n++] = *p;
+    test[n] = '\0';
+
+    printf_uart("  %s: %lu cycles/call", test, b->cycles / ISA_REPEAT);
+    if (k->bytes) {
+        print_uart(", ");
+        bench_print_milli(b->cycles * 1000 / ((uint64_t)ISA_REPEAT * k->bytes));
+        print_uart(" cycles/byte");
+    }
+    if (base_cycles && b->cycles) {
+        print_uart(", speedup ");
+        bench_print_milli(base_cycles * 1000 / b->cycles);
+        print_uart("x");
+    }
+    printf_uart(", %s\n", errors == 0 ? "PASS" : "FAIL");
+    result_emit(test, b->cycles / ISA_REPEAT, b->instret / ISA_REPEAT, k->bytes, errors);
+}
+
+int main()
+{
+    int errors = 0;
+    char text[21];
+
+    if (init_uart(PLAT_CLK_FREQ, PLAT_UART_BAUD) != 0)
+        return 1;
+    bench_header("ISA Dispatch");
+    isa_report();
+    print_uart("\n");
+
+    // 每种绑定都先检查标准测试向量
+    uint32_t bound = isa_info()->bound;
+    uint32_t configs[2] = {0, bound};
+    for (int c = 0; c < 2; c++) {
+        isa_bind(configs[c]);
+        if (isa_crc32(0, "123456789", 9) != CRC32_CHECK_VALUE ||
+            isa_utoa(18446744073709551615ULL, text) != 20 || text[19] != '5' ||
+            isa_utoa(0, text) != 1 || text[0] != '0') {
+            printf_uart("self-check failed (crc32=%s, utoa=%s)\n", isa_ops.crc32_impl, isa_ops.utoa_impl);
+            errors++;
+        }
+    }
+
+    prepare();
+    print_uart("=== dispatch ===\n");
+    for (unsigned i = 0; i < sizeof(kernels) / sizeof(kernels[0]); i++) {
+        const isa_kernel_t *k = &kernels[i];
+        bench_t base, best;
+
+        isa_bind(0);
+        const char *base_impl = k->impl();
+        uint64_t expect = measure(k, &base);
+        report(k, base_impl, &base, 0, 0);
+
+        isa_bind(bound);
+        if (same_name(k->impl(), base_impl))
+            continue;
+        uint64_t got = measure(k, &best);
+        int bad = got != expect;
+        if (bad)
+            printf_uart("  %s: %s returned 0x%lx, %s returned 0x%lx\n", k->name, k->impl(), got, base_impl, expect);
+        report(k, k->impl(), &best, base.cycles, bad);
+        errors += bad;
+    }
+    isa_bind(bound);
+
+    print_uart("\n");
+    if (errors == 0)
+        print_uart("ISA dispatch passed\n");
+    else
+        printf_uart("ISA dispatch: %d error(s)\n", errors);
+    return errors;
+}
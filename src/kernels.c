@@ -0,0 +1,289 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Embedded Kernel Set (CRC32 / MatMul / Sort / FIR) with Self-Check
+//////////////////////////////////////////////////////////////////////////////////
+
+// 每个内核重复 KERNEL_REPEAT 次计时，输入由固定种子的 xorshift 生成，
+// 结果与参考值比对：CRC32 用标准测试向量和主机算出的校验和，
+// 排序检查有序性和元素和，矩阵乘与 FIR 用主机算出的校验和。
+//
+// make MAIN=kernels EXTRA_CFLAGS="-DKERNEL_REPEAT=20"
+
+#include <stdint.h>
+#include "uart.h"
+#include "bench.h"
+
+#ifndef KERNEL_REPEAT
+#define KERNEL_REPEAT 4
+#endif
+
+#define CRC_BUF_LEN   4096
+#define MATMUL_N      16
+#define SORT_LEN      512
+#define FIR_TAPS      32
+#define FIR_LEN       1024
+
+// 参考值，由同一份源码在主机上算出
+#define CRC32_CHECK_VALUE   0xCBF43926  // CRC32("123456789")
+#define CRC32_BUF_EXPECTED  0x614183EE
+#define MATMUL_EXPECTED     0x9B54D01E
+#define FIR_EXPECTED        0xD9865AAE
+
+static uint8_t  crc_buf[CRC_BUF_LEN];
+static uint32_t crc_table[256];
+static int32_t  mat_a[MATMUL_N][MATMUL_N];
+static int32_t  mat_b[MATMUL_N][MATMUL_N];
+static int32_t  mat_c[MATMUL_N][MATMUL_N];
+static uint32_t sort_src[SORT_LEN];
+static uint32_t sort_buf[SORT_LEN];
+static int16_t  fir_in[FIR_LEN];
+static int16_t  fir_out[FIR_LEN];
+static int16_t  fir_coef[FIR_TAPS];
+
+/////////////////////////////////////////////////////
+// CRC32 (IEEE 802.3, 反射多项式, 查表)
+/////////////////////////////////////////////////////
+
+static void crc32_init(void)
+{
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++)
+            c = (c & 1) ? (c >> 1) ^ 0xEDB88320 : c >> 1;
+        crc_table[i] = c;
+    }
+}
+
+static uint32_t crc32(const uint8_t *data, uint32_t len)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    for (uint32_t i = 0; i < len; i++)
+        crc = crc_table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFF;
+}
+
+static int run_crc32(void)
+{
+    static const char check[] = "123456789";
+    int errors = 0;
+    uint32_t seed = 0x12345678;
+    uint32_t crc = 0;
+
+    crc32_init();
+    for (int i = 0; i < CRC_BUF_LEN; i++)
+        crc_buf[i] = bench_rand(&seed);
+
+    if (crc32((const uint8_t *)check, 9) != CRC32_CHECK_VALUE)
+        errors++;
+
+    print_uart("=== crc32 ===\n");
+    bench_t b;
+    bench_start(&b);
+    for (int r = 0; r < KERNEL_REPEAT; r++)
+        crc = crc32(crc_buf, CRC_BUF_LEN);
+    bench_stop(&b);
+
+    if (crc != CRC32_BUF_EXPECTED) {
+        printf_uart("crc32: got 0x%x, expected 0x%x\n", crc, CRC32_BUF_EXPECTED);
+        errors++;
+    }
+    bench_report("crc32", &b, KERNEL_REPEAT, errors);
+    printf_uart("        cycles/byte: %lu\n", b.cycles / ((uint64_t)KERNEL_REPEAT * CRC_BUF_LEN));
+    return errors;
+}
+
+/////////////////////////////////////////////////////
+// 整数矩阵乘
+/////////////////////////////////////////////////////
+
+static void matmul(void)
+{
+    for (int i = 0; i < MATMUL_N; i++)
+        for (int j = 0; j < MATMUL_N; j++) {
+            int32_t acc = 0;
+            for (int k = 0; k < MATMUL_N; k++)
+                acc += mat_a[i][k] * mat_b[k][j];
+            mat_c[i][j] = acc;
+        }
+}
+
+static int run_matmul(void)
+{
+    int errors = 0;
+    uint32_t seed = 0x9e3779b9;
+    uint32_t sum = 0;
+
+    for (int i = 0; i < MATMUL_N; i++)
+        for (int j = 0; j < MATMUL_N; j++) {
+            mat_a[i][j] = (int32_t)(bench_rand(&seed) & 0x3ff) - 0x200;
+            mat_b[i][j] = (int32_t)(bench_rand(&seed) & 0x3ff) - 0x200;
+        }
+
+    print_uart("=== matmul ===\n");
+    bench_t b;
+    bench_start(&b);
+    for (int r = 0; r < KERNEL_REPEAT; r++)
+        matmul();
+    bench_stop(&b);
+
+    // 按位置加权求和，行列错位也能查出来
+    for (int i = 0; i < MATMUL_N; i++)
+        for (int j = 0; j < MATMUL_N; j++)
+            sum = sum * 31 + (uint32_t)mat_c[i][j];
+    if (sum != MATMUL_EXPECTED) {
+        printf_uart("matmul: got 0x%x, expected 0x%x\n", sum, MATMUL_EXPECTED);
+        errors++;
+    }
+    bench_report("matmul", &b, KERNEL_REPEAT, errors);
+    printf_uart("        cycles/MAC: %lu\n",
+                b.cycles / ((uint64_t)KERNEL_REPEAT * MATMUL_N * MATMUL_N * MATMUL_N));
+    return errors;
+}
+
+/////////////////////////////////////////////////////
+// 排序 (堆排序，无递归、无额外内存)
+/////////////////////////////////////////////////////
+
+static void sift_down(uint32_t *a, int root, int end)
+{
+    while (2 * root + 1 <= end) {
+        int child = 2 * root + 1;
+        if (child + 1 <= end && a[child] < a[child + 1])
+            child++;
+        if (a[root] >= a[child])
+            return;
+        uint32_t t = a[root];
+        a[root] = a[child];
+        a[child] = t;
+        root = child;
+    }
+}
+
+static void heap_sort(uint32_t *a, int n)
+{
+    for (int start = n / 2 - 1; start >= 0; start--)
+        sift_down(a, start, n - 1);
+    for (int end = n - 1; end > 0; end--) {
+        uint32_t t = a[0];
+        a[0] = a[end];
+        a[end] = t;
+        sift_down(a, 0, end - 1);
+    }
+}
+
+static int run_sort(void)
+{
+    int errors = 0;
+    uint32_t seed = 0xdeadbeef;
+    uint64_t src_sum = 0;
+    uint64_t dst_sum = 0;
+
+    for (int i = 0; i < SORT_LEN; i++) {
+        sort_src[i] = bench_rand(&seed);
+        src_sum += sort_src[i];
+    }
+
+    print_uart("=== sort ===\n");
+    bench_t b;
+    b.cycles = 0;
+    b.instret = 0;
+    for (int r = 0; r < KERNEL_REPEAT; r++) {
+        // 每轮都从未排序数据开始，拷贝不计入时间
+        for (int i = 0; i < SORT_LEN; i++)
+            sort_buf[i] = sort_src[i];
+        bench_t one;
+        bench_start(&one);
+        heap_sort(sort_buf, SORT_LEN);
+        bench_stop(&one);
+        b.cycles += one.cycles;
+        b.instret += one.instret;
+    }
+
+    for (int i = 0; i < SORT_LEN; i++) {
+        dst_sum += sort_buf[i];
+        if (i > 0 && sort_buf[i - 1] > sort_buf[i])
+            errors++;
+    }
+    if (dst_sum != src_sum)
+        errors++;
+    bench_report("sort", &b, KERNEL_REPEAT, errors);
+    printf_uart("        cycles/element: %lu\n", b.cycles / ((uint64_t)KERNEL_REPEAT * SORT_LEN));
+    return errors;
+}
+
+/////////////////////////////////////////////////////
+// FIR (Q15 定点)
+/////////////////////////////////////////////////////
+
+static void fir(const int16_t *in, int16_t *out, int len)
+{
+    for (int n = 0; n < len; n++) {
+        int32_t acc = 0;
+        int taps = n + 1 < FIR_TAPS ? n + 1 : FIR_TAPS;
+        for (int k = 0; k < taps; k++)
+            acc += (int32_t)fir_coef[k] * in[n - k];
+        acc >>= 15;
+        if (acc > 32767)
+            acc = 32767;
+        if (acc < -32768)
+            acc = -32768;
+        out[n] = (int16_t)acc;
+    }
+}
+
+static int run_fir(void)
+{
+    int errors = 0;
+    uint32_t seed = 0x0badf00d;
+    uint32_t sum = 0;
+
+    // 对称低通系数，总和约 0.9 (Q15)
+    for (int k = 0; k < FIR_TAPS / 2; k++) {
+        int16_t c = (int16_t)(120 + k * 110);
+        fir_coef[k] = c;
+        fir_coef[FIR_TAPS - 1 - k] = c;
+    }
+    for (int i = 0; i < FIR_LEN; i++)
+        fir_in[i] = (int16_t)(bench_rand(&seed) & 0xffff);
+
+    print_uart("=== fir ===\n");
+    bench_t b;
+    bench_start(&b);
+    for (int r = 0; r < KERNEL_REPEAT; r++)
+        fir(fir_in, fir_out, FIR_LEN);
+    bench_stop(&b);
+
+    for (int i = 0; i < FIR_LEN; i++)
+        sum = sum * 31 + (uint16_t)fir_out[i];
+    if (sum != FIR_EXPECTED) {
+        printf_uart("fir: got 0x%x, expected 0x%x\n", sum, FIR_EXPECTED);
+        errors++;
+    }
+    bench_report("fir", &b, KERNEL_REPEAT, errors);
+    printf_uart("        cycles/sample: %lu\n", b.cycles / ((uint64_t)KERNEL_REPEAT * FIR_LEN));
+    return errors;
+}
+
+/////////////////////////////////////////////////////
+
+int main()
+{
+    int errors = 0;
+
+    if (init_uart(PLAT_CLK_FREQ, PLAT_UART_BAUD) != 0)
+        return 1;
+    bench_header("Embedded Kernel Set");
+
+    errors += run_crc32();
+    errors += run_matmul();
+    errors += run_sort();
+    errors += run_fir();
+
+    print_uart("\n");
+    if (errors == 0)
+        print_uart("All kernels passed\n");
+    else
+        printf_uart("Kernel self-check failed: %d error(s)\n", errors);
+
+    return 0;
+}
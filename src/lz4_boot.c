@@ -0,0 +1,33 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     LZ4 Self-Extracting Boot Image (make COMPRESS=1)
+//////////////////////////////////////////////////////////////////////////////////
+
+// 压缩镜像的解压由 src/lz4_stub.S 完成，这里只保存并报告它记录的统计。
+// main() 开始前 UART 还没有初始化，所以统计在程序退出时输出。
+
+#include "lz4_boot.h"
+#include "exit.h"
+#include "result.h"
+#include "uart.h"
+#include <stdint.h>
+
+lz4_boot_info_t lz4_boot_info;
+
+void lz4_boot_report(void)
+{
+    if (lz4_boot_info.magic != LZ4_BOOT_MAGIC)
+        return;
+    printf_uart("LZ4 boot: %lu -> %lu bytes in %lu cycles\n",
+                lz4_boot_info.packed, lz4_boot_info.unpacked, lz4_boot_info.cycles);
+    result_emit("boot.lz4", lz4_boot_info.cycles, 0, lz4_boot_info.unpacked, 0);
+}
+
+#ifdef LZ4_BOOT_AUTO
+// make COMPRESS=1 时注册退出钩子（由 startup.S 执行 .init_array）
+__attribute__((constructor))
+static void lz4_boot_autostart(void)
+{
+    atexit(lz4_boot_report);
+}
+#endif
@@ -0,0 +1,46 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     LZ4 Self-Extracting Boot Image (make COMPRESS=1)
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// src/lz4_stub.S 与 utils/lz4pack.py 共用的载荷格式，字段均为 64 位
+#define LZ4_BOOT_MAGIC      0x4c5a3442      // "LZ4B"
+
+#define LZ4_HDR_MAGIC       0
+#define LZ4_HDR_ENTRY       8               // 解压后跳转的地址（原 ELF 入口）
+#define LZ4_HDR_INFO        16              // lz4_boot_info 的地址，0 表示不记录
+#define LZ4_HDR_RELOC_END   24              // 搬移后载荷的结束地址
+#define LZ4_HDR_COUNT       32
+#define LZ4_HDR_PACKED      40
+#define LZ4_HDR_UNPACKED    48
+#define LZ4_HDR_SIZE        64
+
+#define LZ4_REC_DST         0
+#define LZ4_REC_RAW         8
+#define LZ4_REC_COMP        16
+#define LZ4_REC_OFFSET      24              // 压缩数据相对载荷起点的偏移
+#define LZ4_REC_SIZE        32
+
+// 搬移距离下限，保证搬移循环所在的镜像开头不会被自己覆盖
+#define LZ4_MIN_SHIFT       256
+
+#ifndef __ASSEMBLER__
+
+#include <stdint.h>
+
+// 解压完成后由 stub 写入；不是从压缩镜像启动时 magic 为 0
+typedef struct {
+    uint64_t magic;
+    uint64_t cycles;            // 搬移 + 解压用的 mcycle
+    uint64_t packed;
+    uint64_t unpacked;
+} lz4_boot_info_t;
+
+extern lz4_boot_info_t lz4_boot_info;
+
+// 输出解压统计和一条 @RESULT（boot.lz4），make COMPRESS=1 时在程序退出时自动调用
+void lz4_boot_report(void);
+
+#endif
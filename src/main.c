@@ -77,7 +77,8 @@ int main() {
   *(mem_base + 1) = (uint64_t)0x11752c63ab69c863;
 
   // function call
-  init_uart(10000000, 115200);
+  if (init_uart(PLAT_CLK_FREQ, PLAT_UART_BAUD) != 0)
+    return 1;
   print_uart("Hello, World!\n");
 
   return 0;
@@ -0,0 +1,67 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Freestanding memcpy/memset/memmove/memcmp
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "mem.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// 本文件禁止把下面的循环再识别成 memcpy/memset，否则会递归调用自身
+#pragma GCC optimize("no-tree-loop-distribute-patterns")
+
+void *memcpy(void *dst, const void *src, size_t n)
+{
+    uint8_t *d = dst;
+    const uint8_t *s = src;
+
+    // 两端同为8字节对齐时按双字拷贝
+    if ((((uintptr_t)d | (uintptr_t)s) & 7) == 0) {
+        for (; n >= 8; n -= 8, d += 8, s += 8)
+            *(uint64_t *)d = *(const uint64_t *)s;
+    }
+    while (n--)
+        *d++ = *s++;
+    return dst;
+}
+
+void *memmove(void *dst, const void *src, size_t n)
+{
+    uint8_t *d = dst;
+    const uint8_t *s = src;
+
+    if (d <= s || d >= s + n)
+        return memcpy(dst, src, n);
+    // 重叠且目标在后，从尾部向前拷贝
+    d += n;
+    s += n;
+    while (n--)
+        *--d = *--s;
+    return dst;
+}
+
+void *memset(void *dst, int c, size_t n)
+{
+    uint8_t *d = dst;
+
+    if (((uintptr_t)d & 7) == 0) {
+        uint64_t v = (uint8_t)c * 0x0101010101010101ULL;
+        for (; n >= 8; n -= 8, d += 8)
+            *(uint64_t *)d = v;
+    }
+    while (n--)
+        *d++ = (uint8_t)c;
+    return dst;
+}
+
+int memcmp(const void *a, const void *b, size_t n)
+{
+    const uint8_t *p = a;
+    const uint8_t *q = b;
+
+    for (; n > 0; n--, p++, q++) {
+        if (*p != *q)
+            return *p - *q;
+    }
+    return 0;
+}
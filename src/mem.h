@@ -0,0 +1,19 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Freestanding memcpy/memset/memmove/memcmp
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stddef.h>
+
+// -nostdlib 下没有 libc，但 GCC 在 -O2 以上会把清零/拷贝循环和大结构体
+// 赋值变成对这几个函数的调用，程序包含本头文件即可链接到 mem.c 中的实现。
+
+void *memcpy(void *dst, const void *src, size_t n);
+
+void *memmove(void *dst, const void *src, size_t n);
+
+void *memset(void *dst, int c, size_t n);
+
+int memcmp(const void *a, const void *b, size_t n);
@@ -0,0 +1,282 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Memory Latency Map: Pointer Chasing over RAM / SPM / PSRAM
+//////////////////////////////////////////////////////////////////////////////////
+
+// 与 lmbench lat_mem_rd 相同的方法：在工作集中每 MEMLAT_STRIDE 字节放一个指针，
+// 用 Sattolo 算法打乱成一个覆盖所有节点的环，每次取数都依赖上一次的结果，
+// 平均每次取数的周期即为该工作集大小下的取数到使用延迟。工作集从 1KB 倍增到区域可用大小：
+//   ram   : 主存中栈顶 PLAT_STACK_TOP 之上的剩余空间（到 __ram_size，程序和栈都在栈顶以下）
+//   spm   : 便笺存储器中 .custom_data 和 .spm_bss 之后的剩余空间（到 __spm_size）
+//   psram : PSRAM 中 .dram_data 和 .dram_bss 之后的剩余空间（到 __dram_size），
+//           且不超过 DRAM 控制器 address_mask_msb 决定的 1 << msb 字节窗口，更高的地址位
+//           不参与译码，会回绕到窗口开头，覆盖 .dram_data
+// 另外在 PSRAM 上按固定步长取数（每次先写回并移出缓存），步长从 8 字节倍增，
+// 延迟的台阶对应突发长度和行大小。
+//
+// make MAIN=mem_latency
+// make MAIN=mem_latency EXTRA_CFLAGS="-Wl,--defsym=__ram_size=0x100000 -DMEMLAT_ADDR_MASK_MSB=22"
+
+#include <stdint.h>
+#include "bench.h"
+#include "cache.h"
+#include "csr.h"
+#include "platform.h"
+#include "result.h"
+#include "sections.h"
+#include "timer.h"
+#include "uart.h"
+
+#define MEMLAT_RAM_BASE     0x80000000
+#define MEMLAT_SPM_BASE     0x30000000
+#define MEMLAT_PSRAM_BASE   0xa0000000
+
+// 相邻节点的间隔，不小于缓存行，每次取数落在不同的缓存行
+#ifndef MEMLAT_STRIDE
+#define MEMLAT_STRIDE       64
+#endif
+
+// 每个工作集至少计时的取数次数（小工作集绕环多圈）
+#ifndef MEMLAT_MIN_LOADS
+#define MEMLAT_MIN_LOADS    4096
+#endif
+
+#define MEMLAT_MIN_BYTES    1024
+
+// 步长测试：每个步长取数 MEMLAT_ROW_LOADS 次，冷启动重复 MEMLAT_ROW_REPEAT 遍取平均
+#ifndef MEMLAT_ROW_LOADS
+#define MEMLAT_ROW_LOADS    64
+#endif
+#ifndef MEMLAT_ROW_REPEAT
+#define MEMLAT_ROW_REPEAT   4
+#endif
+
+// DRAM 控制器 address_mask_msb 寄存器（见 dram_func.c 的 init_dram）；
+// 定义 MEMLAT_ADDR_MASK_MSB 时先写入该值，否则只读出当前设置
+#define MEMLAT_DRAMCTL_ADDR_MASK_MSB 0xe0000030
+
+// linker.ld 中的容量（符号的地址即数值）
+extern char __ram_size[], __spm_size[], __dram_size[];
+
+typedef struct {
+    const char *name;
+    uintptr_t base;
+    uint64_t bytes;
+} memlat_region_t;
+
+static volatile uintptr_t memlat_sink;
+
+static uint64_t xorshift64(uint64_t *state)
+{
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+// 在 [base, base + n * stride) 中建立随机单环：先在每个节点中存下标，
+// Sattolo 洗牌后节点 i 的值就是环上的下一个节点，再换成地址，不需要额外内存
+static void build_chain(uintptr_t base, uint64_t n, uint64_t stride, uint64_t seed)
+{
+    for (uint64_t i = 0; i < n; i++)
+        *(uint64_t *)(base + i * stride) = i;
+    for (uint64_t i = n - 1; i > 0; i--) {
+        uint64_t j = xorshift64(&seed) % i;
+        uint64_t *a = (uint64_t *)(base + i * stride);
+        uint64_t *b = (uint64_t *)(base + j * stride);
+        uint64_t t = *a;
+        *a = *b;
+        *b = t;
+    }
+    for (uint64_t i = 0; i < n; i++) {
+        uint64_t *p = (uint64_t *)(base + i * stride);
+        *p = base + *p * stride;
+    }
+}
+
+// 顺序环：节点 i 指向 i + 1，最后一个指回起点
+static void build_linear(uintptr_t base, uint64_t n, uint64_t stride)
+{
+    for (uint64_t i = 0; i < n; i++)
+        *(uint64_t *)(base + i * stride) = base + ((i + 1) % n) * stride;
+}
+
+// loads 为 8 的倍数
+__attribute__((noinline))
+static uintptr_t chase(uintptr_t p, uint64_t loads)
+{
+    for (uint64_t i = loads / 8; i; i--) {
+        p = *(volatile uintptr_t *)p;
+        p = *(volatile uintptr_t *)p;
+        p = *(volatile uintptr_t *)p;
+        p = *(volatile uintptr_t *)p;
+        p = *(volatile uintptr_t *)p;
+        p = *(volatile uintptr_t *)p;
+        p = *(volatile uintptr_t *)p;
+        p = *(volatile uintptr_t *)p;
+    }
+    return p;
+}
+
+static void print_size(uint64_t bytes)
+{
+    if (bytes >= 1024 * 1024)
+        printf_uart("%lu MB", bytes >> 20);
+    else if (bytes >= 1024)
+        printf_uart("%lu KB", bytes >> 10);
+    else
+        printf_uart("%lu B", bytes);
+}
+
+// 测试名为 <区域>.<prefix><value><suffix>，如 psram.64k / psram.row256
+static void emit(const char *region, const char *prefix, uint64_t value, const char *suffix,
+                 uint64_t cycles, uint64_t instret, uint64_t bytes)
+{
+    char test[32];
+    char digits[20];
+    int n = 0, d = 0;
+    for (const char *p = region; *p; p++)
+        test[n++] = *p;
+    test[n++] = '.';
+    for (const char *p = prefix; *p; p++)
+        test[n++] = *p;
+    do {
+        digits[d++] = '0' + value % 10;
+        value /= 10;
+    } while (value);
+    while (d)
+        test[n++] = digits[--d];
+    for (const char *p = suffix; *p; p++)
+        test[n++] = *p;
+    test[n] = '\0';
+    result_emit(test, cycles, instret, bytes, 0);
+}
+
+// 输出每次取数的周期和纳秒（三位小数）
+static void print_latency(uint64_t cycles, uint64_t loads)
+{
+    uint32_t per_us = timer_cycles_per_us();
+    bench_print_milli(cycles * 1000 / loads);
+    print_uart(" cycles, ");
+    bench_print_milli(per_us ? cycles * 1000000 / ((uint64_t)per_us * loads) : 0);
+    print_uart(" ns\n");
+}
+
+static void latency_curve(const memlat_region_t *r)
+{
+    if (r->bytes == 0) {
+        printf_uart("[%s] skipped, no usable space\n\n", r->name);
+        return;
+    }
+    printf_uart("[%s] 0x%lx, ", r->name, (uint64_t)r->base);
+    print_size(r->bytes);
+    print_uart(" available\n");
+
+    for (uint64_t size = MEMLAT_MIN_BYTES; size <= r->bytes; size <<= 1) {
+        uint64_t n = size / MEMLAT_STRIDE;
+        if (n < 2)
+            continue;
+        build_chain(r->base, n, MEMLAT_STRIDE, 0x9e3779b97f4a7c15ULL ^ size);
+
+        uint64_t loads = n < MEMLAT_MIN_LOADS ? MEMLAT_MIN_LOADS : n;
+        loads = (loads + 7) & ~7ULL;
+        // 先走一圈，使能放进缓存的工作集处于热状态
+        uintptr_t p = chase(r->base, (n + 7) & ~7ULL);
+
+        bench_t b;
+        bench_start(&b);
+        p = chase(p, loads);
+        bench_stop(&b);
+        memlat_sink = p;
+
+        printf_uart("  %s ", r->name);
+        print_size(size);
+        print_uart(": ");
+        print_latency(b.cycles, loads);
+        if (size >= 1024 * 1024)
+            emit(r->name, "", size >> 20, "m", b.cycles, b.instret, size);
+        else
+            emit(r->name, "", size >> 10, "k", b.cycles, b.instret, size);
+    }
+    print_uart("\n");
+}
+
+static uint32_t dram_addr_mask_msb(void)
+{
+    volatile uint64_t *reg = (volatile uint64_t *)MEMLAT_DRAMCTL_ADDR_MASK_MSB;
+#ifdef MEMLAT_ADDR_MASK_MSB
+    *reg = MEMLAT_ADDR_MASK_MSB;
+#endif
+    return (uint32_t)*reg;
+}
+
+// 冷缓存下按固定步长取数，每次取数都要访问 PSRAM；r 已按 msb 限制在译码窗口内
+static void row_probe(const memlat_region_t *r, uint32_t msb)
+{
+    uint64_t limit = r->bytes / MEMLAT_ROW_LOADS;
+
+    printf_uart("[%s row/burst] address_mask_msb: %u, %d loads per stride, cold cache (%s)\n",
+                r->name, msb, MEMLAT_ROW_LOADS, cache_impl_name());
+    if (msb == 0 || msb >= 63)
+        printf_uart("  address_mask_msb reads %u (controller not initialized?), limited by region size\n", msb);
+
+    for (uint64_t stride = 8; stride <= limit; stride <<= 1) {
+        build_linear(r->base, MEMLAT_ROW_LOADS, stride);
+        uint64_t cycles = 0, instret = 0;
+        for (int rep = 0; rep < MEMLAT_ROW_REPEAT; rep++) {
+            cache_flush_all();
+            bench_t b;
+            bench_start(&b);
+            memlat_sink = chase(r->base, MEMLAT_ROW_LOADS);
+            bench_stop(&b);
+            cycles += b.cycles;
+            instret += b.instret;
+        }
+        printf_uart("  stride %lu B: ", stride);
+        print_latency(cycles, (uint64_t)MEMLAT_ROW_LOADS * MEMLAT_ROW_REPEAT);
+        emit(r->name, "row", stride, "", cycles / MEMLAT_ROW_REPEAT, instret / MEMLAT_ROW_REPEAT,
+             stride * MEMLAT_ROW_LOADS);
+    }
+    print_uart("\n");
+}
+
+static uint64_t align_up(uint64_t v, uint64_t a)
+{
+    return (v + a - 1) & ~(a - 1);
+}
+
+int main()
+{
+    if (init_uart(PLAT_CLK_FREQ, PLAT_UART_BAUD) != 0)
+        return 1;
+    bench_header("Memory Latency Map");
+    printf_uart("Node stride %d B, at least %d loads per working set\n\n", MEMLAT_STRIDE, MEMLAT_MIN_LOADS);
+
+    uintptr_t spm = align_up((uintptr_t)__spm_bss_end, 4096);
+    uintptr_t psram = align_up((uintptr_t)__dram_bss_end, 4096);
+    uint64_t spm_end = MEMLAT_SPM_BASE + (uint64_t)__spm_size;
+    uint64_t psram_end = MEMLAT_PSRAM_BASE + (uint64_t)__dram_size;
+    uintptr_t ram = align_up(PLAT_STACK_TOP, 4096);
+    uint64_t ram_end = MEMLAT_RAM_BASE + (uint64_t)__ram_size;
+
+    // 超出 address_mask_msb 窗口的地址回绕到 PSRAM 开头，工作集和步长测试都不能越过
+    uint32_t msb = dram_addr_mask_msb();
+    if (msb > 0 && msb < 63 && MEMLAT_PSRAM_BASE + (1ULL << msb) < psram_end)
+        psram_end = MEMLAT_PSRAM_BASE + (1ULL << msb);
+
+    memlat_region_t regions[] = {
+        {"ram", ram, ram < ram_end ? ram_end - ram : 0},
+        {"spm", spm, spm < spm_end ? spm_end - spm : 0},
+        {"psram", psram, psram < psram_end ? psram_end - psram : 0},
+    };
+
+    for (unsigned i = 0; i < sizeof(regions) / sizeof(regions[0]); i++)
+        latency_curve(&regions[i]);
+    if (regions[2].bytes != 0)
+        row_probe(&regions[2], msb);
+
+    print_uart("Latency map complete\n");
+    return 0;
+}
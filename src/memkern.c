@@ -0,0 +1,271 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Bulk Memory Kernels (fill / copy / verify / XOR), RVV with Scalar Fallback
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "memkern.h"
+#include "csr.h"
+#include <stdint.h>
+#include <stddef.h>
+
+// 填充循环不能被识别成 memset
+#pragma GCC optimize("no-tree-loop-distribute-patterns")
+
+#if defined(__riscv_vector) && !defined(MEMKERN_VECTOR)
+#define MEMKERN_VECTOR
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// 标量实现：每次迭代处理 4 个字，减少循环开销
+////////////////////////////////////////////////////////////////////////////////
+
+static void scalar_fill(uint64_t *dst, uint64_t pattern, size_t words)
+{
+    for (; words >= 4; words -= 4, dst += 4) {
+        dst[0] = pattern;
+        dst[1] = pattern;
+        dst[2] = pattern;
+        dst[3] = pattern;
+    }
+    while (words--)
+        *dst++ = pattern;
+}
+
+static void scalar_copy(uint64_t *dst, const uint64_t *src, size_t words)
+{
+    for (; words >= 4; words -= 4, dst += 4, src += 4) {
+        uint64_t a = src[0], b = src[1], c = src[2], d = src[3];
+        dst[0] = a;
+        dst[1] = b;
+        dst[2] = c;
+        dst[3] = d;
+    }
+    while (words--)
+        *dst++ = *src++;
+}
+
+static size_t scalar_verify(const uint64_t *src, uint64_t pattern, size_t words)
+{
+    size_t i = 0;
+    // 先按 4 个字一组合并比较，有差异时再逐个定位
+    for (; i + 4 <= words; i += 4) {
+        uint64_t diff = (src[i] ^ pattern) | (src[i + 1] ^ pattern) |
+                        (src[i + 2] ^ pattern) | (src[i + 3] ^ pattern);
+        if (diff)
+            break;
+    }
+    for (; i < words; i++) {
+        if (src[i] != pattern)
+            return i;
+    }
+    return words;
+}
+
+static uint64_t scalar_xor(const uint64_t *src, size_t words)
+{
+    uint64_t a = 0, b = 0, c = 0, d = 0;
+    for (; words >= 4; words -= 4, src += 4) {
+        a ^= src[0];
+        b ^= src[1];
+        c ^= src[2];
+        d ^= src[3];
+    }
+    while (words--)
+        a ^= *src++;
+    return a ^ b ^ c ^ d;
+}
+
+#ifdef MEMKERN_VECTOR
+////////////////////////////////////////////////////////////////////////////////
+// RVV 1.0 实现：e64/m8，每条向量访存指令处理 8 个向量寄存器长度的数据
+// 基础 -march 不含 v 时用 .option arch 临时打开，编译器也不认识向量寄存器名，
+// 此时编译器自身不会生成向量代码，不需要声明向量寄存器被修改
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __riscv_vector
+#define MEMKERN_VREGS , "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7", \
+    "v8", "v9", "v10", "v11", "v12", "v13", "v14", "v15", \
+    "v16", "v17", "v18", "v19", "v20", "v21", "v22", "v23", "vl", "vtype"
+#else
+#define MEMKERN_VREGS
+#endif
+
+#define RVV_BEGIN ".option push\n.option arch, +v\n"
+#define RVV_END   ".option pop\n"
+
+static void vector_fill(uint64_t *dst, uint64_t pattern, size_t words)
+{
+    if (words == 0)
+        return;
+    __asm__ volatile(
+        RVV_BEGIN
+        "vsetvli t0, zero, e64, m8, ta, ma\n"
+        "vmv.v.x v0, %[pat]\n"
+        "1:\n"
+        "vsetvli t0, %[n], e64, m8, ta, ma\n"
+        "vse64.v v0, (%[dst])\n"
+        "sub %[n], %[n], t0\n"
+        "slli t0, t0, 3\n"
+        "add %[dst], %[dst], t0\n"
+        "bnez %[n], 1b\n"
+        RVV_END
+        : [dst] "+r"(dst), [n] "+r"(words)
+        : [pat] "r"(pattern)
+        : "t0", "memory" MEMKERN_VREGS);
+}
+
+static void vector_copy(uint64_t *dst, const uint64_t *src, size_t words)
+{
+    if (words == 0)
+        return;
+    __asm__ volatile(
+        RVV_BEGIN
+        "1:\n"
+        "vsetvli t0, %[n], e64, m8, ta, ma\n"
+        "vle64.v v0, (%[src])\n"
+        "vse64.v v0, (%[dst])\n"
+        "sub %[n], %[n], t0\n"
+        "slli t0, t0, 3\n"
+        "add %[src], %[src], t0\n"
+        "add %[dst], %[dst], t0\n"
+        "bnez %[n], 1b\n"
+        RVV_END
+        : [dst] "+r"(dst), [src] "+r"(src), [n] "+r"(words)
+        :
+        : "t0", "memory" MEMKERN_VREGS);
+}
+
+static size_t vector_verify(const uint64_t *src, uint64_t pattern, size_t words)
+{
+    size_t idx = 0;
+    long first = -1;
+    if (words == 0)
+        return 0;
+    // vmsne 产生不相等掩码，vfirst 给出第一个置位元素，没有时为 -1
+    __asm__ volatile(
+        RVV_BEGIN
+        "1:\n"
+        "vsetvli t0, %[n], e64, m8, ta, ma\n"
+        "vle64.v v8, (%[src])\n"
+        "vmsne.vx v0, v8, %[pat]\n"
+        "vfirst.m %[first], v0\n"
+        "bgez %[first], 2f\n"
+        "sub %[n], %[n], t0\n"
+        "add %[idx], %[idx], t0\n"
+        "slli t0, t0, 3\n"
+        "add %[src], %[src], t0\n"
+        "bnez %[n], 1b\n"
+        "2:\n"
+        RVV_END
+        : [src] "+r"(src), [n] "+r"(words), [idx] "+r"(idx), [first] "+r"(first)
+        : [pat] "r"(pattern)
+        : "t0", "memory" MEMKERN_VREGS);
+    return first >= 0 ? idx + first : idx;
+}
+
+static uint64_t vector_xor(const uint64_t *src, size_t words)
+{
+    uint64_t result = 0;
+    if (words == 0)
+        return 0;
+    // 按元素累加到 v8，最后一次 vl 可能较小，用 tu 保留其余元素，结束后整体归约
+    __asm__ volatile(
+        RVV_BEGIN
+        "vsetvli t0, zero, e64, m8, ta, ma\n"
+        "vmv.v.i v8, 0\n"
+        "1:\n"
+        "vsetvli t0, %[n], e64, m8, tu, ma\n"
+        "vle64.v v16, (%[src])\n"
+        "vxor.vv v8, v8, v16\n"
+        "sub %[n], %[n], t0\n"
+        "slli t0, t0, 3\n"
+        "add %[src], %[src], t0\n"
+        "bnez %[n], 1b\n"
+        "vsetvli t0, zero, e64, m8, ta, ma\n"
+        "vmv.s.x v16, zero\n"
+        "vredxor.vs v16, v8, v16\n"
+        "vmv.x.s %[res], v16\n"
+        RVV_END
+        : [src] "+r"(src), [n] "+r"(words), [res] "=r"(result)
+        :
+        : "t0", "memory" MEMKERN_VREGS);
+    return result;
+}
+#endif
+
+// -1: 尚未检测
+static int memkern_mode = -1;
+static int memkern_has_v;
+
+static void memkern_probe(void)
+{
+#ifdef MEMKERN_VECTOR
+    if (read_csr(misa) & MISA_EXT('V')) {
+        // mstatus.VS 为 Off 时执行向量指令会触发非法指令异常
+        if ((read_csr(mstatus) & MSTATUS_VS) == 0)
+            set_csr(mstatus, MSTATUS_VS_INIT);
+        memkern_has_v = 1;
+    }
+#endif
+    memkern_mode = memkern_has_v;
+}
+
+int memkern_vector(void)
+{
+    if (memkern_mode < 0)
+        memkern_probe();
+    return memkern_mode;
+}
+
+int memkern_set_vector(int enable)
+{
+    if (memkern_mode < 0)
+        memkern_probe();
+    memkern_mode = enable && memkern_has_v;
+    return memkern_mode;
+}
+
+const char *memkern_impl_name(void)
+{
+    return memkern_vector() ? "rvv" : "scalar";
+}
+
+void memkern_fill(uint64_t *dst, uint64_t pattern, size_t words)
+{
+#ifdef MEMKERN_VECTOR
+    if (memkern_vector()) {
+        vector_fill(dst, pattern, words);
+        return;
+    }
+#endif
+    scalar_fill(dst, pattern, words);
+}
+
+void memkern_copy(uint64_t *dst, const uint64_t *src, size_t words)
+{
+#ifdef MEMKERN_VECTOR
+    if (memkern_vector()) {
+        vector_copy(dst, src, words);
+        return;
+    }
+#endif
+    scalar_copy(dst, src, words);
+}
+
+size_t memkern_verify(const uint64_t *src, uint64_t pattern, size_t words)
+{
+#ifdef MEMKERN_VECTOR
+    if (memkern_vector())
+        return vector_verify(src, pattern, words);
+#endif
+    return scalar_verify(src, pattern, words);
+}
+
+uint64_t memkern_xor(const uint64_t *src, size_t words)
+{
+#ifdef MEMKERN_VECTOR
+    if (memkern_vector())
+        return vector_xor(src, words);
+#endif
+    return scalar_xor(src, words);
+}
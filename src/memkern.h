@@ -0,0 +1,30 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Bulk Memory Kernels (fill / copy / verify / XOR), RVV with Scalar Fallback
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// make VECTOR=1（或 -march 含 v）时编入 RVV 1.0 实现，运行时 misa 没有 V 则使用标量实现；
+// 其他情况下只有标量实现。所有长度都以 64 位字计，地址需 8 字节对齐。
+
+// 当前是否使用向量实现
+int memkern_vector(void);
+
+// 强制选择实现，返回实际生效的值（没有 V 时始终为 0）
+int memkern_set_vector(int enable);
+
+const char *memkern_impl_name(void);
+
+void memkern_fill(uint64_t *dst, uint64_t pattern, size_t words);
+
+void memkern_copy(uint64_t *dst, const uint64_t *src, size_t words);
+
+// 返回第一个不等于 pattern 的下标，全部相等时返回 words
+size_t memkern_verify(const uint64_t *src, uint64_t pattern, size_t words);
+
+// 所有字按位异或
+uint64_t memkern_xor(const uint64_t *src, size_t words);
@@ -0,0 +1,147 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Resident UART Boot Menu for Multi-Application Images
+//////////////////////////////////////////////////////////////////////////////////
+
+// make multi APPS="main uart_func dram_func" 时作为 main 链接。
+// 输入程序名（回车结束）运行对应程序，main 返回或调用 exit() 后回到菜单：
+//   list / ? : 列出程序
+//   all      : 依次运行全部程序
+//   quit     : 退出菜单，停在 startup.S 的 loop
+
+#include "apps.h"
+#include "csr.h"
+#include "exit.h"
+#include "mem.h"
+#include "platform.h"
+#include "result.h"
+#include "timer.h"
+#include "uart.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#define MENU_LINE_MAX 32
+
+static void *menu_jmp[5];
+
+static int menu_streq(const char *a, const char *b)
+{
+    while (*a && *a == *b) {
+        a++;
+        b++;
+    }
+    return *a == *b;
+}
+
+static void menu_list(void)
+{
+    printf_uart("Apps (%d):", app_count);
+    for (int i = 0; i < app_count; i++)
+        printf_uart(" %s", app_table[i].name);
+    print_uart("\n");
+}
+
+// 程序可能留下定时器中断、自己的中断处理函数或关闭的中断，回到菜单前恢复上电状态
+static void menu_reset_machine(void)
+{
+    clear_csr(mstatus, MSTATUS_MIE);
+    timer_stop_tick();
+    write_csr(mie, 0);
+    trap_set_mode(TRAP_MODE_VECTORED);
+    trap_reset_handlers();
+}
+
+static void menu_run(const app_t *app)
+{
+    int status;
+
+    memcpy(app->data_start, app->shadow, app->data_end - app->data_start);
+    memset(app->bss_start, 0, app->bss_end - app->bss_start);
+    exit_reset();
+    result_set_program(app->name);
+
+    printf_uart("@APP start %s\n", app->name);
+    uint64_t start = read_csr(mcycle);
+    if (__builtin_setjmp(menu_jmp) == 0) {
+        exit_set_return(menu_jmp);
+        status = app->main();
+        run_exit_hooks();
+    } else {
+        // 从 exit() 返回，退出钩子已执行
+        status = exit_status();
+    }
+    uint64_t cycles = read_csr(mcycle) - start;
+    exit_set_return(NULL);
+    menu_reset_machine();
+
+    printf_uart("\n@APP exit %s %d %lu\n", app->name, status, cycles);
+}
+
+// 阻塞读取一行，忽略 '\r'，超长部分丢弃
+static void menu_read_line(char *line, int max_len)
+{
+    int i = 0;
+    uint8_t c;
+    while (1) {
+        while (!load_uart_char(&c)) {};
+        if (c == '\n')
+            break;
+        if (c != '\r' && i < max_len - 1)
+            line[i++] = c;
+    }
+    line[i] = '\0';
+}
+
+static const app_t *menu_find(const char *name)
+{
+    for (int i = 0; i < app_count; i++) {
+        if (menu_streq(app_table[i].name, name))
+            return &app_table[i];
+    }
+    return NULL;
+}
+
+int main()
+{
+    char line[MENU_LINE_MAX];
+
+    if (init_uart(PLAT_CLK_FREQ, PLAT_UART_BAUD) != 0)
+        return 1;
+
+    // 任何程序运行之前 .data 还是镜像中的初始值
+    for (int i = 0; i < app_count; i++) {
+        const app_t *app = &app_table[i];
+        memcpy(app->shadow, app->data_start, app->data_end - app->data_start);
+    }
+
+    print_uart("=== menu ===\n");
+    menu_list();
+
+    while (1) {
+        print_uart("menu> ");
+        menu_read_line(line, MENU_LINE_MAX);
+        if (line[0] == '\0')
+            continue;
+
+        if (menu_streq(line, "quit"))
+            break;
+        if (menu_streq(line, "list") || menu_streq(line, "?")) {
+            menu_list();
+            continue;
+        }
+        if (menu_streq(line, "all")) {
+            for (int i = 0; i < app_count; i++)
+                menu_run(&app_table[i]);
+            continue;
+        }
+
+        const app_t *app = menu_find(line);
+        if (app)
+            menu_run(app);
+        else
+            printf_uart("Unknown app: %s\n", line);
+    }
+
+    print_uart("=== menu done ===\n");
+    return 0;
+}
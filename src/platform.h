@@ -0,0 +1,21 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Platform Configuration (clocks and defaults)
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// 外设（UART）输入时钟，所有程序统一使用；可用 -DPLAT_CLK_FREQ=... 覆盖
+#ifndef PLAT_CLK_FREQ
+#define PLAT_CLK_FREQ 115000000
+#endif
+
+// 上电默认波特率，也是波特率协商的起点
+#ifndef PLAT_UART_BAUD
+#define PLAT_UART_BAUD 115200
+#endif
+
+// 栈顶（栈向下增长），startup.S 与栈回溯共用
+#ifndef PLAT_STACK_TOP
+#define PLAT_STACK_TOP 0x80020000
+#endif
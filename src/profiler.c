@@ -0,0 +1,208 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Timer-Interrupt Sampling Profiler
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "profiler.h"
+#include "timer.h"
+#include "trap.h"
+#include "exit.h"
+#include "uart.h"
+#include "platform.h"
+#include <stdint.h>
+
+typedef struct {
+    uint64_t pc;
+    uint32_t count;
+} prof_slot_t;
+
+static prof_slot_t prof_hist[PROFILER_SLOTS];
+static volatile uint32_t prof_samples;
+static volatile uint32_t prof_dropped;
+static uint32_t prof_period_us;
+static int prof_running;
+static int prof_exit_hooked;
+
+static void profiler_exit_dump(void);
+
+// 开放寻址最多探测的槽数，超过则丢弃该样本
+#define PROF_MAX_PROBE 16
+
+static inline uint32_t prof_hash(uint64_t x, int bits)
+{
+    return (uint32_t)((x * 0x9E3779B97F4A7C15ULL) >> (64 - bits));
+}
+
+static void prof_record_pc(uint64_t pc)
+{
+    uint32_t idx = prof_hash(pc >> 1, PROFILER_SLOT_BITS);
+    for (int i = 0; i < PROF_MAX_PROBE; i++) {
+        prof_slot_t *s = &prof_hist[(idx + i) & (PROFILER_SLOTS - 1)];
+        if (s->count == 0) {
+            s->pc = pc;
+            s->count = 1;
+            return;
+        }
+        if (s->pc == pc) {
+            s->count++;
+            return;
+        }
+    }
+    prof_dropped++;
+}
+
+#ifdef PROFILER_STACKS
+
+typedef struct {
+    uint64_t pc[PROFILER_STACK_DEPTH];
+    uint32_t depth;
+    uint32_t count;
+} prof_stack_t;
+
+static prof_stack_t prof_stacks[PROFILER_STACK_SLOTS];
+static uint32_t prof_stacks_dropped;
+
+// 按帧指针回溯：RISC-V GCC 的帧布局为 ra 在 fp-8、上一帧 fp 在 fp-16。
+// 被打断处若还在函数序言中，s0 仍是调用者的帧，会少一层，可以接受。
+static void prof_record_stack(trap_frame_t *tf)
+{
+    uint64_t pcs[PROFILER_STACK_DEPTH];
+    uint32_t depth = 0;
+    uint64_t fp = tf->s[0];
+    uint64_t lo = (uint64_t)(uintptr_t)tf;
+
+    pcs[depth++] = tf->mepc;
+    while (depth < PROFILER_STACK_DEPTH) {
+        if ((fp & 7) || fp <= lo + 16 || fp > PLAT_STACK_TOP)
+            break;
+        uint64_t ra = ((uint64_t *)(uintptr_t)fp)[-1];
+        uint64_t next = ((uint64_t *)(uintptr_t)fp)[-2];
+        if (ra == 0)
+            break;
+        pcs[depth++] = ra;
+        lo = fp;
+        fp = next;
+    }
+
+    uint64_t key = depth;
+    for (uint32_t i = 0; i < depth; i++)
+        key = (key ^ pcs[i]) * 0x100000001B3ULL;
+
+    uint32_t idx = prof_hash(key, 30) % PROFILER_STACK_SLOTS;
+    for (int n = 0; n < PROF_MAX_PROBE; n++) {
+        prof_stack_t *s = &prof_stacks[(idx + n) % PROFILER_STACK_SLOTS];
+        if (s->count == 0) {
+            for (uint32_t i = 0; i < depth; i++)
+                s->pc[i] = pcs[i];
+            s->depth = depth;
+            s->count = 1;
+            return;
+        }
+        if (s->depth == depth) {
+            uint32_t i = 0;
+            while (i < depth && s->pc[i] == pcs[i])
+                i++;
+            if (i == depth) {
+                s->count++;
+                return;
+            }
+        }
+    }
+    prof_stacks_dropped++;
+}
+
+#endif
+
+static void profiler_tick(trap_frame_t *tf)
+{
+    prof_samples++;
+    prof_record_pc(tf->mepc);
+#ifdef PROFILER_STACKS
+    prof_record_stack(tf);
+#endif
+}
+
+int profiler_start(uint32_t period_us)
+{
+    if (timer_start_tick(period_us, profiler_tick) != 0)
+        return -1;
+    prof_period_us = period_us;
+    prof_running = 1;
+    if (!prof_exit_hooked) {
+        prof_exit_hooked = 1;
+        atexit(profiler_exit_dump);
+    }
+    return 0;
+}
+
+void profiler_stop(void)
+{
+    if (prof_running) {
+        timer_stop_tick();
+        prof_running = 0;
+    }
+}
+
+void profiler_reset(void)
+{
+    uint64_t irq = disable_interrupts();
+    for (int i = 0; i < PROFILER_SLOTS; i++)
+        prof_hist[i].count = 0;
+#ifdef PROFILER_STACKS
+    for (int i = 0; i < PROFILER_STACK_SLOTS; i++)
+        prof_stacks[i].count = 0;
+    prof_stacks_dropped = 0;
+#endif
+    prof_samples = 0;
+    prof_dropped = 0;
+    restore_interrupts(irq);
+}
+
+static void prof_emit(void)
+{
+    printf_uart("@PROF begin %u %u %u\n", prof_period_us, prof_samples, prof_dropped);
+    for (int i = 0; i < PROFILER_SLOTS; i++) {
+        if (prof_hist[i].count != 0)
+            printf_uart("@PROF pc %lx %u\n", prof_hist[i].pc, prof_hist[i].count);
+    }
+#ifdef PROFILER_STACKS
+    for (int i = 0; i < PROFILER_STACK_SLOTS; i++) {
+        prof_stack_t *s = &prof_stacks[i];
+        if (s->count == 0)
+            continue;
+        printf_uart("@PROF stack %u", s->count);
+        for (uint32_t d = 0; d < s->depth; d++)
+            printf_uart(" %lx", s->pc[d]);
+        print_uart("\n");
+    }
+    if (prof_stacks_dropped != 0)
+        printf_uart("@PROF stack_dropped %u\n", prof_stacks_dropped);
+#endif
+    print_uart("@PROF end\n");
+}
+
+// 输出期间暂停采样，否则结果里全是 UART 轮询
+void profiler_dump(void)
+{
+    int was_running = prof_running;
+    profiler_stop();
+    prof_emit();
+    if (was_running)
+        profiler_start(prof_period_us);
+}
+
+// 退出钩子：程序已经结束，输出后不再恢复采样（多程序镜像中 tick 会一直打断菜单）
+static void profiler_exit_dump(void)
+{
+    profiler_stop();
+    prof_emit();
+}
+
+#ifdef PROFILER_AUTOSTART
+// make PROFILE=1 时在 main 之前开始采样（由 startup.S 执行 .init_array）
+__attribute__((constructor))
+static void profiler_autostart(void)
+{
+    profiler_start(PROFILER_AUTOSTART);
+}
+#endif
@@ -0,0 +1,37 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Timer-Interrupt Sampling Profiler
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+// 采样直方图的槽数（2 的幂），每个槽记录一个精确的 mepc 及其命中次数
+#ifndef PROFILER_SLOT_BITS
+#define PROFILER_SLOT_BITS 9
+#endif
+#define PROFILER_SLOTS (1 << PROFILER_SLOT_BITS)
+
+// 调用栈采样（需要 -fno-omit-frame-pointer，make PROFILE=1 会自动打开）
+#ifndef PROFILER_STACK_DEPTH
+#define PROFILER_STACK_DEPTH 8
+#endif
+#ifndef PROFILER_STACK_SLOTS
+#define PROFILER_STACK_SLOTS 64
+#endif
+
+// 以 period_us 为周期采样，程序退出时停止采样并自动输出一次结果
+// 采样占用 CLINT 定时器 tick，期间不能再调用 timer_start_tick()
+int profiler_start(uint32_t period_us);
+
+void profiler_stop(void);
+
+void profiler_reset(void);
+
+// 通过 UART 输出 @PROF 记录，由 utils/profile_report.py 解析：
+//   @PROF begin <period_us> <samples> <dropped>
+//   @PROF pc <mepc> <count>
+//   @PROF stack <count> <pc0> <ra1> <ra2> ...   (pc0 为被打断处，之后为返回地址)
+//   @PROF end
+void profiler_dump(void);
@@ -0,0 +1,43 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Machine-Readable Result Records (@RESULT JSON lines)
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "result.h"
+#include "uart.h"
+#include <stdint.h>
+
+static const char *result_prog = RESULT_PROGRAM;
+
+void result_set_program(const char *program)
+{
+    result_prog = program;
+}
+
+const char *result_program(void)
+{
+    return result_prog;
+}
+
+// 名称中的引号和反斜杠需要转义，控制字符直接丢弃
+static void result_print_string(const char *s)
+{
+    print_uart_char('"');
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\')
+            print_uart_char('\\');
+        if ((unsigned char)*s >= ' ')
+            print_uart_char(*s);
+    }
+    print_uart_char('"');
+}
+
+void result_emit(const char *test, uint64_t cycles, uint64_t instret, uint64_t bytes, uint32_t errors)
+{
+    print_uart("@RESULT {\"program\":");
+    result_print_string(result_prog);
+    print_uart(",\"test\":");
+    result_print_string(test);
+    printf_uart(",\"cycles\":%lu,\"instret\":%lu,\"bytes\":%lu,\"errors\":%u}\n",
+                cycles, instret, bytes, errors);
+}
@@ -0,0 +1,23 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Machine-Readable Result Records (@RESULT JSON lines)
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+// 每条结果输出为一行：
+//   @RESULT {"program":"kernels","test":"crc32","cycles":123,"instret":456,"bytes":0,"errors":0}
+// 由 utils/results.py 收集并与基线比较；不适用的字段填 0
+
+// 程序名默认取编译时的 MAIN（Makefile 传入 -DRESULT_PROGRAM），多程序镜像由 menu.c 切换
+#ifndef RESULT_PROGRAM
+#define RESULT_PROGRAM "unknown"
+#endif
+
+void result_set_program(const char *program);
+
+const char *result_program(void);
+
+void result_emit(const char *test, uint64_t cycles, uint64_t instret, uint64_t bytes, uint32_t errors);
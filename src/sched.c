@@ -0,0 +1,192 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Cooperative Task Scheduler (stackful tasks, single hart)
+//////////////////////////////////////////////////////////////////////////////////
+
+// 调度器运行在 main 的栈上：任务让出时切回调度器，由调度器按轮转顺序选择下一个任务，
+// 每次让出是两次 context_switch。没有可运行任务时在 timer_wait_until 中 wfi。
+// 任务之间不会被抢占，只在 task_yield / task_sleep_us / 等待 UART 时切换。
+
+#include "sched.h"
+#include "context.h"
+#include "csr.h"
+#include "timer.h"
+#include "uart.h"
+#include <stdint.h>
+#include <stddef.h>
+
+static task_t tasks[SCHED_MAX_TASKS];
+static context_t sched_ctx;
+static int sched_current = -1;
+static int sched_next;
+static uint64_t sched_total_cycles;
+static uint64_t sched_idle_cycles;
+
+static void task_entry(void *p)
+{
+    task_t *t = p;
+    t->fn(t->arg);
+    task_exit();
+}
+
+int task_create(const char *name, task_fn_t fn, void *arg, void *stack, size_t stack_size)
+{
+    int id = -1;
+    for (int i = 0; i < SCHED_MAX_TASKS; i++) {
+        if (tasks[i].state == TASK_FREE || tasks[i].state == TASK_DONE) {
+            id = i;
+            break;
+        }
+    }
+    if (id < 0 || stack_size < 256)
+        return -1;
+
+    task_t *t = &tasks[id];
+    uintptr_t bottom = ((uintptr_t)stack + 7) & ~(uintptr_t)7;
+    uintptr_t top = ((uintptr_t)stack + stack_size) & ~(uintptr_t)15;
+
+    *t = (task_t){0};
+    t->name = name;
+    t->fn = fn;
+    t->arg = arg;
+    t->stack_bottom = (uint64_t *)bottom;
+    *t->stack_bottom = SCHED_STACK_CANARY;
+
+    // 第一次切换到该任务时从 context_trampoline 进入 task_entry(t)
+    t->ctx.ra = (uintptr_t)context_trampoline;
+    t->ctx.sp = top;
+    t->ctx.s[0] = (uintptr_t)t;
+    t->ctx.s[1] = (uintptr_t)task_entry;
+    t->state = TASK_READY;
+    return id;
+}
+
+static void sched_dispatch(int id)
+{
+    task_t *t = &tasks[id];
+
+    sched_current = id;
+    t->switches++;
+    uint64_t start = read_mcycle();
+    context_switch(&sched_ctx, &t->ctx);
+    t->cycles += read_mcycle() - start;
+    sched_current = -1;
+
+    if (*t->stack_bottom != SCHED_STACK_CANARY) {
+        printf_uart("sched: stack overflow in task %s, task stopped\n", t->name);
+        t->state = TASK_DONE;
+    }
+}
+
+void sched_run(void)
+{
+    uint64_t start = read_mcycle();
+
+    while (1) {
+        int alive = 0;
+        int picked = -1;
+        uint64_t earliest = UINT64_MAX;
+        uint64_t now = timer_mtime();
+
+        for (int n = 0; n < SCHED_MAX_TASKS; n++) {
+            int id = (sched_next + n) % SCHED_MAX_TASKS;
+            task_t *t = &tasks[id];
+            if (t->state == TASK_SLEEPING) {
+                if (now >= t->wake) {
+                    t->state = TASK_READY;
+                } else {
+                    alive = 1;
+                    if (t->wake < earliest)
+                        earliest = t->wake;
+                    continue;
+                }
+            }
+            if (t->state == TASK_READY) {
+                picked = id;
+                break;
+            }
+        }
+
+        if (picked >= 0) {
+            sched_next = (picked + 1) % SCHED_MAX_TASKS;
+            sched_dispatch(picked);
+            continue;
+        }
+        if (!alive)
+            break;
+
+        // 全部任务都在睡眠
+        uint64_t idle_start = read_mcycle();
+        timer_wait_until(earliest);
+        sched_idle_cycles += read_mcycle() - idle_start;
+    }
+
+    sched_total_cycles += read_mcycle() - start;
+}
+
+void task_yield(void)
+{
+    if (sched_current < 0)
+        return;
+    context_switch(&tasks[sched_current].ctx, &sched_ctx);
+}
+
+void task_sleep_us(uint64_t us)
+{
+    if (sched_current < 0) {
+        delay_us(us);
+        return;
+    }
+    task_t *t = &tasks[sched_current];
+    t->wake = deadline_in_us(us);
+    t->state = TASK_SLEEPING;
+    context_switch(&t->ctx, &sched_ctx);
+}
+
+void task_exit(void)
+{
+    // 不在任务中（main 或中断处理函数）时没有可以切回的调度器，用断点异常停下，
+    // trap.c 输出寄存器（mepc 即调用处）后停机
+    if (sched_current < 0) {
+        print_uart("ERROR! task_exit() called outside a task\n");
+        while (1)
+            __asm__ volatile ("ebreak");
+    }
+    task_t *t = &tasks[sched_current];
+    t->state = TASK_DONE;
+    context_switch(&t->ctx, &sched_ctx);
+    __builtin_unreachable();
+}
+
+int task_current(void)
+{
+    return sched_current;
+}
+
+// 覆盖 uart.c 中的弱定义：任务等待 UART 收发时让出处理器
+void uart_idle(void)
+{
+    if (sched_current >= 0)
+        task_yield();
+}
+
+static void sched_print_share(uint64_t part, uint64_t total)
+{
+    uint64_t permille = total ? part * 1000 / total : 0;
+    printf_uart("%lu.%u%%", permille / 10, (uint32_t)(permille % 10));
+}
+
+void sched_print_stats(void)
+{
+    printf_uart("[sched] cycles: %lu, idle: %lu (", sched_total_cycles, sched_idle_cycles);
+    sched_print_share(sched_idle_cycles, sched_total_cycles);
+    print_uart(")\n");
+    for (int i = 0; i < SCHED_MAX_TASKS; i++) {
+        task_t *t = &tasks[i];
+        if (t->state == TASK_FREE)
+            continue;
+        printf_uart("  %s: runs %lu, cycles %lu (", t->name, t->switches, t->cycles);
+        sched_print_share(t->cycles, sched_total_cycles);
+        print_uart(")\n");
+    }
+}
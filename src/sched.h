@@ -0,0 +1,58 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Cooperative Task Scheduler (stackful tasks, single hart)
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "context.h"
+
+#ifndef SCHED_MAX_TASKS
+#define SCHED_MAX_TASKS 8
+#endif
+
+// 栈底写入的哨兵值，每次切换时检查是否被覆盖
+#define SCHED_STACK_CANARY 0x5354414b43414e59ULL
+
+typedef void (*task_fn_t)(void *arg);
+
+typedef enum {
+    TASK_FREE = 0,
+    TASK_READY,
+    TASK_SLEEPING,
+    TASK_DONE
+} task_state_t;
+
+typedef struct {
+    context_t    ctx;
+    task_state_t state;
+    const char  *name;
+    task_fn_t    fn;
+    void        *arg;
+    uint64_t    *stack_bottom;
+    uint64_t     wake;          // TASK_SLEEPING 时的唤醒时刻（mtime）
+    uint64_t     switches;      // 被调度运行的次数
+    uint64_t     cycles;        // 累计运行周期
+} task_t;
+
+// 创建任务，stack 由调用者提供（建议静态数组，16 字节对齐）；返回任务号，满时返回 -1
+int task_create(const char *name, task_fn_t fn, void *arg, void *stack, size_t stack_size);
+
+// 运行全部任务直到都结束；没有可运行任务时用 wfi 等待最早的唤醒时刻
+void sched_run(void);
+
+// 以下只能在任务中调用
+void task_yield(void);
+
+void task_sleep_us(uint64_t us);
+
+// 任务函数返回时也会自动调用；不在任务中调用时输出错误并触发断点异常，不会返回
+void task_exit(void) __attribute__((noreturn));
+
+// 当前任务号，在调度器（main）中调用时返回 -1
+int task_current(void);
+
+// 输出每个任务的调度次数、运行周期占比以及空闲周期
+void sched_print_stats(void);
@@ -0,0 +1,181 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Cooperative Scheduler Demo: DRAM Test Overlapped with UART Output
+//////////////////////////////////////////////////////////////////////////////////
+
+// 同一组 DRAM 块测试运行两遍：
+//   serial     : 测完一块立即输出结果，UART 发送期间 CPU 忙等
+//   overlapped : worker 任务做测试并把结果放入队列，streamer 任务负责输出；
+//                streamer 等待 UART 发送 FIFO 时让出处理器给 worker
+// 另有一个 heartbeat 任务每 1ms 醒来一次，演示 task_sleep_us。
+
+#include <stdint.h>
+#include "csr.h"
+#include "memkern.h"
+#include "result.h"
+#include "platform.h"
+#include "sched.h"
+#include "sections.h"
+#include "timer.h"
+#include "uart.h"
+
+#ifndef DEMO_BLOCK_WORDS
+#define DEMO_BLOCK_WORDS    2048
+#endif
+#define DEMO_BLOCKS         8
+#define DEMO_PATTERNS       4
+#define DEMO_QUEUE_SIZE     8       // 2 的幂
+#define DEMO_STACK_WORDS    512
+#define DEMO_HEARTBEAT_US   1000
+
+static const uint64_t demo_patterns[DEMO_PATTERNS] = {
+    0xb6acad2abb260109,
+    0xaaaaaaaaaaaaaaaa,
+    0x0123456789abcdef,
+    0xffffffffffffffff
+};
+
+typedef struct {
+    uint32_t block;
+    uint32_t pattern;
+    uint32_t errors;
+    uint64_t cycles;
+} demo_result_t;
+
+static demo_result_t demo_queue[DEMO_QUEUE_SIZE];
+static uint32_t demo_head;
+static uint32_t demo_tail;
+static int demo_worker_done;
+static int demo_streamer_done;
+static uint32_t demo_heartbeats;
+static uint64_t demo_checksum;
+static uint32_t demo_errors;
+
+static uint64_t demo_buf[DEMO_BLOCKS * DEMO_BLOCK_WORDS] __dram_bss __attribute__((aligned(64)));
+
+static uint64_t worker_stack[DEMO_STACK_WORDS] __attribute__((aligned(16)));
+static uint64_t streamer_stack[DEMO_STACK_WORDS] __attribute__((aligned(16)));
+static uint64_t heartbeat_stack[DEMO_STACK_WORDS] __attribute__((aligned(16)));
+
+// 写 pattern 校验，再写取反值校验，并用整块异或再检查一次
+static void demo_test_block(uint32_t block, uint32_t pattern, demo_result_t *r)
+{
+    uint64_t *mem = demo_buf + (uint64_t)block * DEMO_BLOCK_WORDS;
+    uint64_t p = demo_patterns[pattern];
+    uint64_t start = read_mcycle();
+
+    r->block = block;
+    r->pattern = pattern;
+    r->errors = 0;
+    memkern_fill(mem, p, DEMO_BLOCK_WORDS);
+    if (memkern_verify(mem, p, DEMO_BLOCK_WORDS) != DEMO_BLOCK_WORDS)
+        r->errors++;
+    memkern_fill(mem, ~p, DEMO_BLOCK_WORDS);
+    if (memkern_verify(mem, ~p, DEMO_BLOCK_WORDS) != DEMO_BLOCK_WORDS)
+        r->errors++;
+    if (memkern_xor(mem, DEMO_BLOCK_WORDS) != ((DEMO_BLOCK_WORDS & 1) ? ~p : 0))
+        r->errors++;
+    r->cycles = read_mcycle() - start;
+}
+
+static void demo_print(const demo_result_t *r)
+{
+    printf_uart("block %u pattern %u: errors %u, %lu cycles\n",
+                r->block, r->pattern, r->errors, r->cycles);
+    demo_checksum += ((uint64_t)r->errors << 32) + (r->block << 8) + r->pattern + 1;
+    demo_errors += r->errors;
+}
+
+static void worker(void *arg)
+{
+    (void)arg;
+    for (uint32_t p = 0; p < DEMO_PATTERNS; p++) {
+        for (uint32_t b = 0; b < DEMO_BLOCKS; b++) {
+            while (demo_head - demo_tail == DEMO_QUEUE_SIZE)
+                task_yield();
+            demo_test_block(b, p, &demo_queue[demo_head % DEMO_QUEUE_SIZE]);
+            demo_head++;
+            task_yield();
+        }
+    }
+    demo_worker_done = 1;
+}
+
+static void streamer(void *arg)
+{
+    (void)arg;
+    while (!demo_worker_done || demo_tail != demo_head) {
+        if (demo_tail == demo_head) {
+            task_yield();
+            continue;
+        }
+        demo_print(&demo_queue[demo_tail % DEMO_QUEUE_SIZE]);
+        demo_tail++;
+    }
+    uart_flush();
+    demo_streamer_done = 1;
+}
+
+static void heartbeat(void *arg)
+{
+    (void)arg;
+    while (!demo_streamer_done) {
+        task_sleep_us(DEMO_HEARTBEAT_US);
+        demo_heartbeats++;
+    }
+}
+
+static void print_speedup(uint64_t base, uint64_t now)
+{
+    uint64_t milli = now ? base * 1000 / now : 0;
+    printf_uart("Speedup: %lu.%u%u%ux\n", milli / 1000, (uint32_t)(milli / 100 % 10),
+                (uint32_t)(milli / 10 % 10), (uint32_t)(milli % 10));
+}
+
+int main()
+{
+    if (init_uart(PLAT_CLK_FREQ, PLAT_UART_BAUD) != 0)
+        return 1;
+    init_timer();
+
+    printf_uart("Scheduler demo: %u blocks x %u patterns, %u bytes per block, %s kernels\n",
+                DEMO_BLOCKS, DEMO_PATTERNS, DEMO_BLOCK_WORDS * 8, memkern_impl_name());
+
+    print_uart("=== serial ===\n");
+    uint64_t start = read_mcycle();
+    for (uint32_t p = 0; p < DEMO_PATTERNS; p++) {
+        for (uint32_t b = 0; b < DEMO_BLOCKS; b++) {
+            demo_result_t r;
+            demo_test_block(b, p, &r);
+            demo_print(&r);
+        }
+    }
+    uart_flush();
+    uint64_t serial_cycles = read_mcycle() - start;
+    uint64_t serial_checksum = demo_checksum;
+    printf_uart("[serial] cycles: %lu\n", serial_cycles);
+    result_emit("serial", serial_cycles, 0, DEMO_BLOCKS * DEMO_PATTERNS * DEMO_BLOCK_WORDS * 8, demo_errors);
+
+    print_uart("=== overlapped ===\n");
+    demo_checksum = 0;
+    demo_errors = 0;
+    task_create("worker", worker, 0, worker_stack, sizeof(worker_stack));
+    task_create("streamer", streamer, 0, streamer_stack, sizeof(streamer_stack));
+    task_create("heartbeat", heartbeat, 0, heartbeat_stack, sizeof(heartbeat_stack));
+    start = read_mcycle();
+    sched_run();
+    uint64_t overlapped_cycles = read_mcycle() - start;
+    printf_uart("[overlapped] cycles: %lu, heartbeats: %u\n", overlapped_cycles, demo_heartbeats);
+    result_emit("overlapped", overlapped_cycles, 0, DEMO_BLOCKS * DEMO_PATTERNS * DEMO_BLOCK_WORDS * 8,
+                demo_errors + (demo_checksum != serial_checksum));
+    sched_print_stats();
+
+    print_speedup(serial_cycles, overlapped_cycles);
+    if (demo_checksum != serial_checksum)
+        printf_uart("Results differ: 0x%lx vs 0x%lx\n", demo_checksum, serial_checksum);
+    else if (demo_errors != 0)
+        printf_uart("Memory errors: %u\n", demo_errors);
+    else
+        print_uart("Results match, all blocks passed\n");
+    return 0;
+}
@@ -0,0 +1,35 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Placement Macros for NOLOAD Scratchpad / PSRAM Buffers
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+// 未初始化的大缓冲区放到 SPM（0x30000000）或 PSRAM（0xa0001000 起）的 NOLOAD 段，
+// 不占镜像、hex 和加载时间，只检查容量（linker.ld 中的 ASSERT）：
+//   static uint64_t buf[1 << 20] __dram_bss;          // 内容为上电时的值
+//   static uint32_t hist[256] __spm_bss_zeroed;       // 启动时由 startup.S 清零
+// 同一编译单元中放入同一段的变量必须都是非 const 的，否则会报 section type conflict。
+// 有初始值的大数组可用 __dram_data 放入随镜像加载的 .dram_data（不进 .hex，需 ELF 加载）。
+// multi 镜像中各程序的这些缓冲区不会在两次运行之间重新清零。
+
+#define __dram_data         __attribute__((section(".dram_data")))
+#define __dram_bss          __attribute__((section(".dram_bss")))
+#define __dram_bss_zeroed   __attribute__((section(".dram_bss.zero")))
+#define __spm_bss           __attribute__((section(".spm_bss")))
+#define __spm_bss_zeroed    __attribute__((section(".spm_bss.zero")))
+
+extern char __dram_bss_start[], __dram_bss_zero_end[], __dram_bss_end[];
+extern char __spm_bss_start[], __spm_bss_zero_end[], __spm_bss_end[];
+
+static inline uint64_t dram_bss_size(void)
+{
+    return (uint64_t)(__dram_bss_end - __dram_bss_start);
+}
+
+static inline uint64_t spm_bss_size(void)
+{
+    return (uint64_t)(__spm_bss_end - __spm_bss_start);
+}
@@ -0,0 +1,135 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     SMP Boot and Synchronization Primitives (ticket / MCS / barrier / seqcount)
+//////////////////////////////////////////////////////////////////////////////////
+
+// 所有 hart 从 _start 启动，hart 0 执行 main，其余 hart 由 startup.S 跳到
+// smp_secondary_entry：切换到各自的栈后等待 hart 0 在 smp_boot 中写入 SMP_BOOT_MAGIC，
+// 报到后循环等待 smp_run 分派的工作。
+// .bss 不会在启动时清零，从核又可能先于 hart 0 运行，所以用魔数而不是 0/1 作为放行标志。
+
+#include "smp.h"
+#include "csr.h"
+#include "timer.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#define SMP_BOOT_MAGIC 0x534d5042u      // "SMPB"
+
+// hart i（i >= 1）的栈为 smp_stacks[i - 1]
+uint8_t smp_stacks[SMP_MAX_HARTS > 1 ? SMP_MAX_HARTS - 1 : 1][SMP_STACK_SIZE] __attribute__((aligned(16)));
+
+static volatile uint32_t smp_boot_flag SMP_ALIGNED;
+// 已报到的 hart（第 i 位为 hart i）；中间的 hart 可能没有启动，hartid 不一定连续
+static volatile uint32_t smp_online SMP_ALIGNED;
+
+// smp_run 分派的工作；gen 每次加一，从核据此发现新工作，只有 mask 中的 hart 执行
+static struct {
+    smp_fn_t fn;
+    void *arg;
+    uint32_t mask;
+    volatile uint32_t gen;
+} SMP_ALIGNED smp_work;
+
+static volatile uint32_t smp_work_done SMP_ALIGNED;
+
+// 由 smp_secondary_entry 尾调用，不返回
+void smp_secondary_main(uint32_t hart) __attribute__((noreturn));
+
+void smp_secondary_main(uint32_t hart)
+{
+    while (__atomic_load_n(&smp_boot_flag, __ATOMIC_ACQUIRE) != SMP_BOOT_MAGIC)
+        smp_relax();
+    uint32_t gen = __atomic_load_n(&smp_work.gen, __ATOMIC_ACQUIRE);
+    __atomic_fetch_or(&smp_online, 1u << hart, __ATOMIC_RELEASE);
+
+    while (1) {
+        uint32_t now;
+        while ((now = __atomic_load_n(&smp_work.gen, __ATOMIC_ACQUIRE)) == gen)
+            smp_relax();
+        gen = now;
+        if (smp_work.mask & (1u << hart)) {
+            smp_work.fn(smp_work.arg);
+            __atomic_fetch_add(&smp_work_done, 1, __ATOMIC_RELEASE);
+        }
+    }
+}
+
+// startup.S 中 hartid != 0 时跳转到这里（a0 = hartid），此时还没有栈
+__attribute__((naked, used)) void smp_secondary_entry(void)
+{
+    __asm__ volatile (
+        "li   t0, %0\n"
+        "bgeu a0, t0, 2f\n"
+        "la   sp, smp_stacks\n"
+        "li   t0, %1\n"
+        "mul  t1, a0, t0\n"
+        "add  sp, sp, t1\n"
+        "tail smp_secondary_main\n"
+        "2:\n"
+        "wfi\n"
+        "j    2b\n"
+        :: "i"(SMP_MAX_HARTS), "i"(SMP_STACK_SIZE));
+}
+
+int smp_boot(uint32_t timeout_us)
+{
+    // 多程序镜像中再次运行时从核已在等待工作，不会再报到
+    if (smp_boot_flag == SMP_BOOT_MAGIC)
+        return smp_num_harts();
+    smp_online = 1;
+    smp_work_done = 0;
+    __atomic_store_n(&smp_boot_flag, SMP_BOOT_MAGIC, __ATOMIC_RELEASE);
+
+    deadline_t deadline = deadline_in_us(timeout_us);
+    while (smp_num_harts() < SMP_MAX_HARTS && !deadline_expired(deadline))
+        smp_relax();
+    return smp_num_harts();
+}
+
+int smp_num_harts(void)
+{
+    uint32_t mask = __atomic_load_n(&smp_online, __ATOMIC_ACQUIRE);
+    int n = 0;
+    for (; mask; mask &= mask - 1)
+        n++;
+    return n ? n : 1;
+}
+
+uint32_t smp_online_mask(void)
+{
+    uint32_t mask = __atomic_load_n(&smp_online, __ATOMIC_ACQUIRE);
+    return mask ? mask : 1;
+}
+
+void smp_run(smp_fn_t fn, void *arg, int nharts)
+{
+    // 按 hartid 从小到大取 nharts 个在线 hart（含 hart 0），只等待这些 hart 完成
+    uint32_t online = smp_online_mask();
+    uint32_t mask = 0;
+    int n = 0;
+    for (uint32_t h = 0; h < SMP_MAX_HARTS && n < nharts; h++) {
+        if (online & (1u << h)) {
+            mask |= 1u << h;
+            n++;
+        }
+    }
+    smp_work.fn = fn;
+    smp_work.arg = arg;
+    smp_work.mask = mask;
+    smp_work_done = 0;
+    __atomic_fetch_add(&smp_work.gen, 1, __ATOMIC_RELEASE);
+
+    fn(arg);
+    while (__atomic_load_n(&smp_work_done, __ATOMIC_ACQUIRE) < (uint32_t)n - 1)
+        smp_relax();
+}
+
+void smp_barrier_init(smp_barrier_t *b, uint32_t total)
+{
+    b->count = 0;
+    b->sense = 0;
+    b->total = total;
+    for (int i = 0; i < SMP_MAX_HARTS; i++)
+        b->local[i].sense = 0;
+}
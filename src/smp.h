@@ -0,0 +1,196 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     SMP Boot and Synchronization Primitives (ticket / MCS / barrier / seqcount)
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "csr.h"
+
+// 需要 A 扩展（AMO / LR/SC），用 make SMP=1 以 rv64ima 编译
+#ifndef __riscv_atomic
+#error "smp.h needs the A extension, build with make SMP=1"
+#endif
+
+// 支持的最大 hart 数，hartid 不小于该值的 hart 停在 wfi；make SMP=1 HARTS=n 设置
+#ifndef SMP_MAX_HARTS
+#define SMP_MAX_HARTS 4
+#endif
+
+// 在线 hart 用 32 位位图记录
+#if SMP_MAX_HARTS > 32
+#error "SMP_MAX_HARTS must not exceed 32"
+#endif
+
+// 每个从核的栈大小（smp.c 中的静态数组），hart 0 仍使用 PLAT_STACK_TOP
+#ifndef SMP_STACK_SIZE
+#define SMP_STACK_SIZE 4096
+#endif
+
+// 共享数据按缓存行对齐，避免不同 hart 频繁写的变量落在同一行（伪共享）
+#define SMP_CACHE_LINE  64
+#define SMP_ALIGNED     __attribute__((aligned(SMP_CACHE_LINE)))
+
+typedef void (*smp_fn_t)(void *arg);
+
+static inline uint32_t smp_hart_id(void)
+{
+    return (uint32_t)read_mhartid();
+}
+
+static inline void smp_relax(void)
+{
+    __asm__ volatile ("" ::: "memory");
+}
+
+// hart 0 调用：放行从核并等待它们报到，返回在线 hart 数（含 hart 0）
+int smp_boot(uint32_t timeout_us);
+
+int smp_num_harts(void);
+
+// 在线 hart 的位图（第 i 位为 hart i），没有启动的 hart 对应位为 0
+uint32_t smp_online_mask(void);
+
+// 在 hartid 最小的 nharts 个在线 hart 上同时执行 fn(arg)（hart 0 自己也执行），全部返回后才返回；
+// 某个 hart 没有启动时顺延到下一个在线 hart，fn 中的 smp_hart_id() 不一定连续
+void smp_run(smp_fn_t fn, void *arg, int nharts);
+
+////////////////////////////////////////////////////////////////////////////////
+// ticket 自旋锁：先到先得，所有等待者轮询同一个 owner
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+    volatile uint32_t next;
+    volatile uint32_t owner;
+} SMP_ALIGNED ticket_lock_t;
+
+#define TICKET_LOCK_INIT {0, 0}
+
+static inline void ticket_lock(ticket_lock_t *l)
+{
+    uint32_t me = __atomic_fetch_add(&l->next, 1, __ATOMIC_RELAXED);
+    while (__atomic_load_n(&l->owner, __ATOMIC_ACQUIRE) != me)
+        smp_relax();
+}
+
+static inline int ticket_trylock(ticket_lock_t *l)
+{
+    uint32_t owner = __atomic_load_n(&l->owner, __ATOMIC_RELAXED);
+    uint32_t expected = owner;
+    return __atomic_compare_exchange_n(&l->next, &expected, owner + 1, 0,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+static inline void ticket_unlock(ticket_lock_t *l)
+{
+    __atomic_store_n(&l->owner, l->owner + 1, __ATOMIC_RELEASE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// MCS 队列锁：每个等待者轮询自己的节点，释放时只写下一个等待者的缓存行
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct mcs_node {
+    struct mcs_node *volatile next;
+    volatile uint32_t locked;
+} SMP_ALIGNED mcs_node_t;
+
+typedef struct {
+    mcs_node_t *volatile tail;
+} SMP_ALIGNED mcs_lock_t;
+
+#define MCS_LOCK_INIT {0}
+
+static inline void mcs_lock(mcs_lock_t *l, mcs_node_t *node)
+{
+    node->next = NULL;
+    node->locked = 1;
+    mcs_node_t *prev = __atomic_exchange_n(&l->tail, node, __ATOMIC_ACQ_REL);
+    if (prev == NULL)
+        return;
+    __atomic_store_n(&prev->next, node, __ATOMIC_RELEASE);
+    while (__atomic_load_n(&node->locked, __ATOMIC_ACQUIRE))
+        smp_relax();
+}
+
+static inline void mcs_unlock(mcs_lock_t *l, mcs_node_t *node)
+{
+    mcs_node_t *next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+    if (next == NULL) {
+        mcs_node_t *expected = node;
+        if (__atomic_compare_exchange_n(&l->tail, &expected, NULL, 0,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+            return;
+        // 后继者已交换了 tail 但还没来得及链接到本节点
+        while ((next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE)) == NULL)
+            smp_relax();
+    }
+    __atomic_store_n(&next->locked, 0, __ATOMIC_RELEASE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// 翻转方向（sense-reversing）屏障：最后到达者清零计数并翻转全局方向
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+    volatile uint32_t count;
+    volatile uint32_t sense;
+    uint32_t total;
+    struct {
+        uint32_t sense;
+    } SMP_ALIGNED local[SMP_MAX_HARTS];
+} SMP_ALIGNED smp_barrier_t;
+
+void smp_barrier_init(smp_barrier_t *b, uint32_t total);
+
+static inline void smp_barrier_wait(smp_barrier_t *b)
+{
+    uint32_t h = smp_hart_id();
+    uint32_t sense = b->local[h].sense ^ 1;
+    b->local[h].sense = sense;
+    if (__atomic_fetch_add(&b->count, 1, __ATOMIC_ACQ_REL) == b->total - 1) {
+        b->count = 0;
+        __atomic_store_n(&b->sense, sense, __ATOMIC_RELEASE);
+    } else {
+        while (__atomic_load_n(&b->sense, __ATOMIC_ACQUIRE) != sense)
+            smp_relax();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// 序列计数（seqlock 的读侧）：写者之间须另行互斥，读者不写共享数据，读到奇数或
+// 前后序号不同时重读。被保护的数据要以 volatile 访问
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+    volatile uint32_t seq;
+} SMP_ALIGNED seqcount_t;
+
+#define SEQCOUNT_INIT {0}
+
+static inline void seq_write_begin(seqcount_t *s)
+{
+    __atomic_store_n(&s->seq, s->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void seq_write_end(seqcount_t *s)
+{
+    __atomic_store_n(&s->seq, s->seq + 1, __ATOMIC_RELEASE);
+}
+
+static inline uint32_t seq_read_begin(const seqcount_t *s)
+{
+    uint32_t seq;
+    while ((seq = __atomic_load_n(&s->seq, __ATOMIC_ACQUIRE)) & 1)
+        smp_relax();
+    return seq;
+}
+
+static inline int seq_read_retry(const seqcount_t *s, uint32_t seq)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&s->seq, __ATOMIC_RELAXED) != seq;
+}
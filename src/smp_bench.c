@@ -0,0 +1,257 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     SMP Lock / Barrier / Seqcount Contention Benchmark
+//////////////////////////////////////////////////////////////////////////////////
+
+// 对 1..N 个 hart 分别测量：
+//   ticket / mcs : 每个 hart 加锁 SMP_BENCH_ITERS 次，临界区内修改共享计数器；
+//                  输出总周期、每次加锁的平均周期（吞吐）和平均/最大加锁等待
+//   barrier      : 连续通过屏障的每次周期
+//   seqcount     : hart 0 持续写一对互补的值，其余 hart 读并检查是否读到一半的更新
+// 总周期由 hart 0 的 mcycle 在起止屏障之间测量；等待时间由各 hart 自己的 mcycle 测量。
+//
+// make MAIN=smp_bench SMP=1 HARTS=4
+
+#include <stdint.h>
+#include "bench.h"
+#include "csr.h"
+#include "platform.h"
+#include "result.h"
+#include "smp.h"
+#include "timer.h"
+#include "uart.h"
+
+#ifndef SMP_BENCH_ITERS
+#define SMP_BENCH_ITERS 200
+#endif
+
+// 等待从核报到的时间
+#define SMP_BOOT_TIMEOUT_US 10000
+
+typedef struct {
+    uint64_t wait_cycles;       // 加锁等待的累计周期
+    uint64_t wait_max;
+    uint64_t ops;
+    uint64_t retries;
+    uint32_t errors;
+} SMP_ALIGNED hart_stat_t;
+
+typedef struct {
+    int nharts;
+    smp_barrier_t start;
+    uint64_t cycles;            // hart 0 测得的总周期
+} bench_ctx_t;
+
+static bench_ctx_t ctx;
+static hart_stat_t stats[SMP_MAX_HARTS];
+
+static ticket_lock_t ticket = TICKET_LOCK_INIT;
+static mcs_lock_t mcs = MCS_LOCK_INIT;
+static mcs_node_t mcs_nodes[SMP_MAX_HARTS];
+static smp_barrier_t bench_barrier;
+static seqcount_t seq = SEQCOUNT_INIT;
+
+// 临界区保护的共享数据，与锁不在同一缓存行
+static volatile uint64_t shared_counter SMP_ALIGNED;
+static volatile uint64_t shared_a SMP_ALIGNED;
+static volatile uint64_t shared_b;
+static volatile uint32_t writer_done SMP_ALIGNED;
+static volatile uint32_t barrier_arrivals SMP_ALIGNED;
+
+static void stat_wait(hart_stat_t *s, uint64_t cycles)
+{
+    s->wait_cycles += cycles;
+    if (cycles > s->wait_max)
+        s->wait_max = cycles;
+    s->ops++;
+}
+
+// 所有 hart 在起点对齐，hart 0 记录起点时刻
+static uint64_t bench_begin(void)
+{
+    smp_barrier_wait(&ctx.start);
+    return read_mcycle();
+}
+
+static void bench_end(uint64_t start)
+{
+    smp_barrier_wait(&ctx.start);
+    if (smp_hart_id() == 0)
+        ctx.cycles = read_mcycle() - start;
+}
+
+static void ticket_worker(void *arg)
+{
+    hart_stat_t *s = &stats[smp_hart_id()];
+    (void)arg;
+    uint64_t start = bench_begin();
+    for (int i = 0; i < SMP_BENCH_ITERS; i++) {
+        uint64_t t0 = read_mcycle();
+        ticket_lock(&ticket);
+        stat_wait(s, read_mcycle() - t0);
+        shared_counter = shared_counter + 1;
+        ticket_unlock(&ticket);
+    }
+    bench_end(start);
+}
+
+static void mcs_worker(void *arg)
+{
+    uint32_t h = smp_hart_id();
+    hart_stat_t *s = &stats[h];
+    (void)arg;
+    uint64_t start = bench_begin();
+    for (int i = 0; i < SMP_BENCH_ITERS; i++) {
+        uint64_t t0 = read_mcycle();
+        mcs_lock(&mcs, &mcs_nodes[h]);
+        stat_wait(s, read_mcycle() - t0);
+        shared_counter = shared_counter + 1;
+        mcs_unlock(&mcs, &mcs_nodes[h]);
+    }
+    bench_end(start);
+}
+
+static void barrier_worker(void *arg)
+{
+    hart_stat_t *s = &stats[smp_hart_id()];
+    (void)arg;
+    uint64_t start = bench_begin();
+    for (int i = 0; i < SMP_BENCH_ITERS; i++) {
+        __atomic_fetch_add(&barrier_arrivals, 1, __ATOMIC_RELAXED);
+        uint64_t t0 = read_mcycle();
+        smp_barrier_wait(&bench_barrier);
+        stat_wait(s, read_mcycle() - t0);
+        // 通过屏障时所有 hart 都应已到达本轮
+        if (__atomic_load_n(&barrier_arrivals, __ATOMIC_RELAXED) < (uint32_t)ctx.nharts * (i + 1))
+            s->errors++;
+    }
+    bench_end(start);
+}
+
+static void seq_worker(void *arg)
+{
+    hart_stat_t *s = &stats[smp_hart_id()];
+    (void)arg;
+    uint64_t start = bench_begin();
+    if (smp_hart_id() == 0) {
+        for (uint64_t i = 1; i <= SMP_BENCH_ITERS; i++) {
+            uint64_t t0 = read_mcycle();
+            seq_write_begin(&seq);
+            shared_a = i;
+            shared_b = ~i;
+            seq_write_end(&seq);
+            stat_wait(s, read_mcycle() - t0);
+        }
+        __atomic_store_n(&writer_done, 1, __ATOMIC_RELEASE);
+    } else {
+        while (!__atomic_load_n(&writer_done, __ATOMIC_ACQUIRE)) {
+            uint64_t a, b;
+            uint32_t v;
+            uint64_t t0 = read_mcycle();
+            do {
+                v = seq_read_begin(&seq);
+                a = shared_a;
+                b = shared_b;
+                s->retries++;
+            } while (seq_read_retry(&seq, v));
+            s->retries--;
+            stat_wait(s, read_mcycle() - t0);
+            if (a != ~b)
+                s->errors++;
+        }
+    }
+    bench_end(start);
+}
+
+static void reset_stats(int nharts)
+{
+    for (int i = 0; i < SMP_MAX_HARTS; i++)
+        stats[i] = (hart_stat_t){0};
+    ctx.nharts = nharts;
+    ctx.cycles = 0;
+    smp_barrier_init(&ctx.start, nharts);
+    smp_barrier_init(&bench_barrier, nharts);
+    shared_counter = 0;
+    shared_a = 0;
+    shared_b = ~0ULL;
+    writer_done = 0;
+    barrier_arrivals = 0;
+}
+
+// 汇总各 hart 的统计并输出，返回错误数
+static uint32_t report(const char *name, int nharts, uint32_t errors)
+{
+    uint64_t ops = 0, wait = 0, wait_max = 0, retries = 0;
+    // 参与的 hart 不一定是 0..nharts-1，未参与的统计已清零
+    for (int i = 0; i < SMP_MAX_HARTS; i++) {
+        ops += stats[i].ops;
+        wait += stats[i].wait_cycles;
+        retries += stats[i].retries;
+        if (stats[i].wait_max > wait_max)
+            wait_max = stats[i].wait_max;
+        errors += stats[i].errors;
+    }
+
+    printf_uart("[%s x%d] cycles: %lu, ops: %lu, cycles/op: %lu, wait avg: %lu, max: %lu",
+                name, nharts, ctx.cycles, ops, ops ? ctx.cycles / ops : 0,
+                ops ? wait / ops : 0, wait_max);
+    if (retries)
+        printf_uart(", retries: %lu", retries);
+    printf_uart(", %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    // 测试名如 ticket.h4 / ticket.h4.wait
+    char test[24];
+    int n = 0;
+    for (const char *p = name; *p && n < 12; p++)
+        test[n++] = *p;
+    test[n++] = '.';
+    test[n++] = 'h';
+    if (nharts >= 10)
+        test[n++] = '0' + nharts / 10;
+    test[n++] = '0' + nharts % 10;
+    test[n] = '\0';
+    result_emit(test, ctx.cycles, 0, 0, errors);
+    for (const char *p = ".wait"; *p; p++)
+        test[n++] = *p;
+    test[n] = '\0';
+    result_emit(test, ops ? wait / ops : 0, 0, 0, errors);
+    return errors;
+}
+
+int main()
+{
+    int errors = 0;
+
+    if (init_uart(PLAT_CLK_FREQ, PLAT_UART_BAUD) != 0)
+        return 1;
+    bench_header("SMP Synchronization Benchmark");
+
+    int harts = smp_boot(SMP_BOOT_TIMEOUT_US);
+    printf_uart("Harts online: %d of %d, %d iterations per hart\n\n", harts, SMP_MAX_HARTS, SMP_BENCH_ITERS);
+
+    // 锁测试的计数器不等于总加锁次数说明互斥失效
+    for (int n = 1; n <= harts; n++) {
+        reset_stats(n);
+        smp_run(ticket_worker, 0, n);
+        errors += report("ticket", n, shared_counter != (uint64_t)n * SMP_BENCH_ITERS);
+
+        reset_stats(n);
+        smp_run(mcs_worker, 0, n);
+        errors += report("mcs", n, shared_counter != (uint64_t)n * SMP_BENCH_ITERS);
+
+        reset_stats(n);
+        smp_run(barrier_worker, 0, n);
+        errors += report("barrier", n, 0);
+
+        reset_stats(n);
+        smp_run(seq_worker, 0, n);
+        errors += report("seqcount", n, 0);
+        print_uart("\n");
+    }
+
+    if (errors == 0)
+        print_uart("All SMP tests passed\n");
+    else
+        printf_uart("SMP self-check failed: %d error(s)\n", errors);
+    return 0;
+}
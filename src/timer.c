@@ -0,0 +1,161 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     CLINT Timer Driver (mtime/mtimecmp + mcycle)
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "timer.h"
+#include "trap.h"
+#include "csr.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#define US_PER_SEC 1000000ULL
+
+static uint32_t cycles_per_us;
+static uint64_t tick_period;
+static volatile uint64_t tick_count;
+static irq_handler_t tick_handler;
+
+static inline void write_mtimecmp(uint64_t value)
+{
+    *(volatile uint64_t *)CLINT_MTIMECMP(read_mhartid()) = value;
+}
+
+uint64_t timer_mtime(void)
+{
+    return *(volatile uint64_t *)CLINT_MTIME;
+}
+
+// 以 mtime 为基准测量 1ms 内的 mcycle 增量，得到核时钟频率
+void init_timer(void)
+{
+    uint64_t calib_ticks = TIMER_MTIME_FREQ / 1000;
+    if (calib_ticks == 0)
+        calib_ticks = 1;
+
+    // 对齐到 mtime 跳变沿
+    uint64_t start = timer_mtime();
+    while (timer_mtime() == start) {};
+    start = timer_mtime();
+    uint64_t c0 = read_mcycle();
+
+    while (timer_mtime() - start < calib_ticks) {};
+    uint64_t c1 = read_mcycle();
+
+    uint64_t us = calib_ticks * US_PER_SEC / TIMER_MTIME_FREQ;
+    cycles_per_us = (c1 - c0) / (us ? us : 1);
+
+    write_mtimecmp(-1ULL);
+}
+
+uint32_t timer_cycles_per_us(void)
+{
+    return cycles_per_us;
+}
+
+uint64_t timer_cycles_to_us(uint64_t cycles)
+{
+    return cycles_per_us ? cycles / cycles_per_us : 0;
+}
+
+uint64_t timer_us_to_ticks(uint64_t us)
+{
+    // 拆分计算，避免 us * freq 溢出
+    return (us / US_PER_SEC) * TIMER_MTIME_FREQ + (us % US_PER_SEC) * TIMER_MTIME_FREQ / US_PER_SEC;
+}
+
+uint64_t timer_now_us(void)
+{
+    uint64_t t = timer_mtime();
+    return (t / TIMER_MTIME_FREQ) * US_PER_SEC + (t % TIMER_MTIME_FREQ) * US_PER_SEC / TIMER_MTIME_FREQ;
+}
+
+deadline_t deadline_in_us(uint64_t us)
+{
+    return timer_mtime() + timer_us_to_ticks(us);
+}
+
+int deadline_expired(deadline_t deadline)
+{
+    return timer_mtime() >= deadline;
+}
+
+// 用 wfi 等待到期：周期中断运行时由 tick 唤醒，否则临时借用 mtimecmp
+void timer_wait_until(deadline_t deadline)
+{
+    if (tick_period != 0) {
+        while (deadline > timer_mtime() && deadline - timer_mtime() > tick_period)
+            wfi();
+        while (!deadline_expired(deadline)) {};
+        return;
+    }
+
+    // 全局中断关闭时，MTIP 挂起仍会唤醒 wfi，但不会进入 trap
+    uint64_t irq_state = disable_interrupts();
+    write_mtimecmp(deadline);
+    set_csr(mie, MIP_MTIP);
+    while (!deadline_expired(deadline))
+        wfi();
+    clear_csr(mie, MIP_MTIP);
+    write_mtimecmp(-1ULL);
+    restore_interrupts(irq_state);
+}
+
+void delay_us(uint64_t us)
+{
+    if (cycles_per_us != 0 && us < TIMER_SPIN_US) {
+        uint64_t start = read_mcycle();
+        uint64_t cycles = us * cycles_per_us;
+        while (read_mcycle() - start < cycles) {};
+        return;
+    }
+    timer_wait_until(deadline_in_us(us));
+}
+
+void delay_ms(uint32_t ms)
+{
+    delay_us((uint64_t)ms * 1000);
+}
+
+static void timer_isr(trap_frame_t *tf)
+{
+    uint64_t now = timer_mtime();
+    uint64_t next = *(volatile uint64_t *)CLINT_MTIMECMP(read_mhartid()) + tick_period;
+
+    // 处理过慢时跳过错过的周期，不累积中断
+    if (next <= now)
+        next = now + tick_period;
+    write_mtimecmp(next);
+
+    tick_count++;
+    if (tick_handler != NULL)
+        tick_handler(tf);
+}
+
+int timer_start_tick(uint32_t period_us, irq_handler_t handler)
+{
+    uint64_t period = timer_us_to_ticks(period_us);
+    if (period == 0)
+        return -1;
+
+    tick_handler = handler;
+    tick_period = period;
+    register_irq_handler(IRQ_M_TIMER, timer_isr);
+    write_mtimecmp(timer_mtime() + period);
+    enable_irq(IRQ_M_TIMER);
+    enable_interrupts();
+    return 0;
+}
+
+void timer_stop_tick(void)
+{
+    disable_irq(IRQ_M_TIMER);
+    write_mtimecmp(-1ULL);
+    tick_period = 0;
+    tick_handler = NULL;
+}
+
+uint64_t timer_ticks(void)
+{
+    return tick_count;
+}
@@ -0,0 +1,53 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     CLINT Timer Driver (mtime/mtimecmp + mcycle)
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include "trap.h"
+
+#define CLINT_BASE 0x02000000
+
+#define CLINT_MSIP(hart)        (CLINT_BASE + 4 * (hart))
+#define CLINT_MTIMECMP(hart)    (CLINT_BASE + 0x4000 + 8 * (hart))
+#define CLINT_MTIME             (CLINT_BASE + 0xBFF8)
+
+// mtime 的计数频率（RTC），与核时钟无关，可用 -DTIMER_MTIME_FREQ=... 覆盖
+#ifndef TIMER_MTIME_FREQ
+#define TIMER_MTIME_FREQ 1000000
+#endif
+
+// 短于该时间的延时直接按 mcycle 自旋，不进入 wfi
+#define TIMER_SPIN_US 20
+
+typedef uint64_t deadline_t;
+
+void init_timer(void);
+
+uint64_t timer_mtime(void);
+
+uint64_t timer_now_us(void);
+
+uint64_t timer_us_to_ticks(uint64_t us);
+
+uint32_t timer_cycles_per_us(void);
+
+uint64_t timer_cycles_to_us(uint64_t cycles);
+
+deadline_t deadline_in_us(uint64_t us);
+
+int deadline_expired(deadline_t deadline);
+
+void timer_wait_until(deadline_t deadline);
+
+void delay_us(uint64_t us);
+
+void delay_ms(uint32_t ms);
+
+int timer_start_tick(uint32_t period_us, irq_handler_t handler);
+
+void timer_stop_tick(void);
+
+uint64_t timer_ticks(void);
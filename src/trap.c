@@ -0,0 +1,151 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Machine-Mode Trap Handling
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "trap.h"
+#include "csr.h"
+#include "uart.h"
+#include <stdint.h>
+#include <stddef.h>
+
+static irq_handler_t irq_handlers[IRQ_COUNT];
+static irq_handler_t exc_handlers[EXC_COUNT];
+
+// startup.S 的 irq_*_entry 按 cause 查表，为空时转入 trap_entry 的完整路径
+fast_irq_handler_t irq_fast_handlers[IRQ_COUNT];
+
+static const char *const exc_names[EXC_COUNT] = {
+    [EXC_INST_MISALIGNED]  = "instruction address misaligned",
+    [EXC_INST_FAULT]       = "instruction access fault",
+    [EXC_ILLEGAL]          = "illegal instruction",
+    [EXC_BREAKPOINT]       = "breakpoint",
+    [EXC_LOAD_MISALIGNED]  = "load address misaligned",
+    [EXC_LOAD_FAULT]       = "load access fault",
+    [EXC_STORE_MISALIGNED] = "store address misaligned",
+    [EXC_STORE_FAULT]      = "store access fault",
+    [EXC_ECALL_M]          = "ecall from M-mode",
+};
+
+void trap_set_mode(int mode)
+{
+    if (mode == TRAP_MODE_VECTORED)
+        write_csr(mtvec, (uintptr_t)trap_vector | TRAP_MODE_VECTORED);
+    else
+        write_csr(mtvec, (uintptr_t)trap_entry);
+}
+
+void trap_reset_handlers(void)
+{
+    for (int i = 0; i < IRQ_COUNT; i++) {
+        irq_handlers[i] = NULL;
+        irq_fast_handlers[i] = NULL;
+    }
+    for (int i = 0; i < EXC_COUNT; i++)
+        exc_handlers[i] = NULL;
+}
+
+void register_irq_handler(int cause, irq_handler_t handler)
+{
+    if (cause >= 0 && cause < IRQ_COUNT)
+        irq_handlers[cause] = handler;
+}
+
+int register_fast_irq_handler(int cause, fast_irq_handler_t handler)
+{
+    if (cause != IRQ_M_SOFT && cause != IRQ_M_TIMER && cause != IRQ_M_EXT)
+        return -1;
+    irq_fast_handlers[cause] = handler;
+    return 0;
+}
+
+void register_exception_handler(int cause, irq_handler_t handler)
+{
+    if (cause >= 0 && cause < EXC_COUNT)
+        exc_handlers[cause] = handler;
+}
+
+void enable_irq(int cause)
+{
+    set_csr(mie, 1ULL << cause);
+}
+
+void disable_irq(int cause)
+{
+    clear_csr(mie, 1ULL << cause);
+}
+
+void enable_interrupts(void)
+{
+    set_csr(mstatus, MSTATUS_MIE);
+}
+
+uint64_t disable_interrupts(void)
+{
+    return clear_csr(mstatus, MSTATUS_MIE) & MSTATUS_MIE;
+}
+
+void restore_interrupts(uint64_t state)
+{
+    if (state & MSTATUS_MIE)
+        set_csr(mstatus, MSTATUS_MIE);
+}
+
+void trap_dump(const trap_frame_t *tf)
+{
+    static const char *const names[] = {
+        "ra", "sp", "gp", "tp",
+        "t0", "t1", "t2", "t3", "t4", "t5", "t6",
+        "s0", "s1", "s2", "s3", "s4", "s5", "s6", "s7", "s8", "s9", "s10", "s11",
+        "a0", "a1", "a2", "a3", "a4", "a5", "a6", "a7",
+    };
+    const uint64_t *regs = &tf->ra;
+    uint64_t code = tf->mcause & ~MCAUSE_INT;
+
+    printf_uart("\nTRAP! mcause: %lx", tf->mcause);
+    if (!(tf->mcause & MCAUSE_INT) && code < EXC_COUNT && exc_names[code] != NULL)
+        printf_uart(" (%s)", exc_names[code]);
+    printf_uart("\n  mepc: %lx  mtval: %lx\n", tf->mepc, tf->mtval);
+    for (unsigned i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        printf_uart("  %s%s: %lx", names[i], names[i][2] ? "" : " ", regs[i]);
+        if (i % 4 == 3)
+            print_uart("\n");
+    }
+    print_uart("\n");
+}
+
+// 由 startup.S 的 trap_entry 调用，返回后从 tf->mepc 继续执行
+void handle_trap(trap_frame_t *tf)
+{
+    if (tf->mcause & MCAUSE_INT) {
+        uint64_t code = tf->mcause & ~MCAUSE_INT;
+        if (code >= IRQ_COUNT) {
+            // 超出处理表范围的中断（平台自定义的本地中断）不能映射到任何处理函数，
+            // 同样按未注册处理：mie 中有对应位（< 64）时关闭，避免中断风暴
+            if (code < 64)
+                clear_csr(mie, 1ULL << code);
+            printf_uart("Unhandled interrupt %lu at %p, disabled\n", code, (void*)tf->mepc);
+            return;
+        }
+        int cause = (int)code;
+        if (irq_fast_handlers[cause] != NULL) {
+            // 直接模式下快速处理函数也经由这里调用
+            irq_fast_handlers[cause]();
+        } else if (irq_handlers[cause] != NULL) {
+            irq_handlers[cause](tf);
+        } else {
+            // 未注册的中断：关闭该中断源，避免中断风暴
+            disable_irq(cause);
+            printf_uart("Unhandled interrupt %u at %p, disabled\n", (uint32_t)cause, (void*)tf->mepc);
+        }
+        return;
+    }
+
+    if (tf->mcause < EXC_COUNT && exc_handlers[tf->mcause] != NULL) {
+        exc_handlers[tf->mcause](tf);
+        return;
+    }
+
+    trap_dump(tf);
+    while (1) {};
+}
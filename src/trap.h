@@ -0,0 +1,82 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Machine-Mode Trap Handling
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+#define IRQ_M_SOFT      3
+#define IRQ_M_TIMER     7
+#define IRQ_M_EXT       11
+#define IRQ_COUNT       16
+
+#define EXC_INST_MISALIGNED     0
+#define EXC_INST_FAULT          1
+#define EXC_ILLEGAL             2
+#define EXC_BREAKPOINT          3
+#define EXC_LOAD_MISALIGNED     4
+#define EXC_LOAD_FAULT          5
+#define EXC_STORE_MISALIGNED    6
+#define EXC_STORE_FAULT         7
+#define EXC_ECALL_M             11
+#define EXC_COUNT               16
+
+// mtvec 模式：直接模式所有 trap 进 trap_entry；向量模式中断按 cause 跳到 trap_vector 表项
+#define TRAP_MODE_DIRECT        0
+#define TRAP_MODE_VECTORED      1
+
+// 由 startup.S 中的 trap_entry 压栈（保存全部通用寄存器），布局需与汇编保持一致
+typedef struct {
+    uint64_t ra;
+    uint64_t sp;            // trap 发生时的 sp
+    uint64_t gp;
+    uint64_t tp;
+    uint64_t t[7];
+    uint64_t s[12];
+    uint64_t a[8];
+    uint64_t mepc;
+    uint64_t mcause;
+    uint64_t mtval;
+} trap_frame_t;
+
+typedef void (*irq_handler_t)(trap_frame_t *tf);
+
+// 快速中断处理函数：向量模式下由 startup.S 的 irq_*_entry 直接调用，
+// 只保存调用者保存寄存器，不构造 trap_frame_t
+typedef void (*fast_irq_handler_t)(void);
+
+extern void trap_entry(void);
+extern void trap_vector(void);
+
+void handle_trap(trap_frame_t *tf);
+
+// 切换 mtvec 模式，startup.S 默认设为 TRAP_MODE_VECTORED
+void trap_set_mode(int mode);
+
+// 取消全部已注册的中断、快速中断和异常处理函数，调用前应先关中断
+void trap_reset_handlers(void);
+
+void register_irq_handler(int cause, irq_handler_t handler);
+
+// 只支持 IRQ_M_SOFT / IRQ_M_TIMER / IRQ_M_EXT，成功返回 0，传 NULL 取消。
+// 优先于 register_irq_handler 注册的处理函数；直接模式下经 trap_entry 的完整路径调用
+int register_fast_irq_handler(int cause, fast_irq_handler_t handler);
+
+// 处理函数返回后从 tf->mepc 继续执行，跳过出错指令需自行加 4
+void register_exception_handler(int cause, irq_handler_t handler);
+
+// 输出 mcause/mepc/mtval 和全部寄存器
+void trap_dump(const trap_frame_t *tf);
+
+void enable_irq(int cause);
+
+void disable_irq(int cause);
+
+void enable_interrupts(void);
+
+// 返回关中断前的 mstatus.MIE，供 restore_interrupts() 恢复
+uint64_t disable_interrupts(void);
+
+void restore_interrupts(uint64_t state);
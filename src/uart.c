@@ -19,42 +19,59 @@ uint8_t read_reg_u8(uintptr_t addr)
     return *(volatile uint8_t *)addr;
 }
 
-int is_transmit_empty()
+// 等待收发时调用，默认什么也不做；sched.c 覆盖为让出处理器
+__attribute__((weak)) void uart_idle(void)
 {
-    return read_reg_u8(UART_LINE_STATUS) & 0x20;
 }
 
-char is_transmit_empty_altera()
-{
-    return ((read_reg_u8(UART_THR+7) << 8 ) + read_reg_u8(UART_THR+6));
-}
-
-int is_receive_empty()
+// 字符收发由 console.h 中编译时选定的后端完成
+void print_uart_char(char a)
 {
-    #ifndef PLAT_AGILEX
-        return !(read_reg_u8(UART_LINE_STATUS) & 0x1);
-    #else
-        return (read_reg_u8(UART_THR) == 0);
-    #endif
+#ifdef UART_TELEMETRY
+    if (!console_tx_ready()) {
+        uint64_t t0 = read_mcycle();
+        while (!console_tx_ready())
+            uart_idle();
+        uart_telemetry_stall(read_mcycle() - t0);
+    }
+    console_tx_byte(a);
+    uart_telem.tx_bytes++;
+#ifdef CONSOLE_HAS_TX_LEVEL
+    uart_telemetry_tx_level(console_tx_level());
+#endif
+#else
+    while (!console_tx_ready())
+        uart_idle();
+    console_tx_byte(a);
+#endif
 }
 
-void print_uart_char(char a)
+int load_uart_char(uint8_t *res)
 {
-    #ifndef PLAT_AGILEX
-        while (is_transmit_empty() == 0) {};
-    #else
-        while (is_transmit_empty_altera() < 8) {};
-    #endif
-    write_reg_u8(UART_THR, a);
+#ifdef UART_TELEMETRY
+#ifdef CONSOLE_HAS_RX_LEVEL
+    uart_telemetry_rx_level(console_rx_level());
+    int got = console_rx_byte(res);
+    uart_telem.rx_bytes += got;
+#else
+    int got = console_rx_byte(res);
+    uart_telemetry_rx(got);
+#endif
+    return got;
+#else
+    return console_rx_byte(res);
+#endif
 }
 
-int load_uart_char(uint8_t *res)
+int load_uart_char_timeout(uint8_t *res, uint64_t timeout_us)
 {
-    if(is_receive_empty()) {
-        return 0;
+    deadline_t deadline = deadline_in_us(timeout_us);
+    while (!load_uart_char(res))
+    {
+        if (deadline_expired(deadline))
+            return 0;
+        uart_idle();
     }
-
-    *res = read_reg_u8(UART_RBR);
     return 1;
 }
 
@@ -78,9 +95,42 @@ uint8_t hex_to_bin(char hex_char) {
     return 0;
 }
 
-void init_uart(uint32_t freq, uint32_t baud)
+static uint32_t uart_baud;
+static int32_t uart_baud_error_ppm;
+
+#ifdef CONSOLE_16550
+// 四舍五入取最接近的分频系数，无法满足误差要求时返回0
+static uint32_t uart_divisor(uint32_t freq, uint32_t baud, uint32_t *actual, int32_t *error_ppm)
 {
-    uint32_t divisor = freq / (baud << 4);
+    if (baud == 0)
+        return 0;
+
+    uint64_t divisor = ((uint64_t)freq + ((uint64_t)baud << 3)) / ((uint64_t)baud << 4);
+    if (divisor == 0 || divisor > 0xFFFF)
+        return 0;
+
+    *actual = freq / (divisor << 4);
+    int64_t error = ((int64_t)*actual - (int64_t)baud) * 1000000 / (int64_t)baud;
+    if (error > UART_MAX_BAUD_ERROR_PPM || error < -UART_MAX_BAUD_ERROR_PPM)
+        return 0;
+
+    *error_ppm = error;
+    return divisor;
+}
+#endif
+
+int init_uart(uint32_t freq, uint32_t baud)
+{
+#ifdef CONSOLE_16550
+    uint32_t actual;
+    int32_t error_ppm;
+    uint32_t divisor = uart_divisor(freq, baud, &actual, &error_ppm);
+    if (divisor == 0) {
+        // 分频寄存器保持原样，这条输出依赖上电或引导程序留下的配置，不一定可见
+        printf_uart("ERROR! init_uart(%u Hz, %u baud): no divisor within %d ppm, check PLAT_CLK_FREQ\n",
+                    freq, baud, UART_MAX_BAUD_ERROR_PPM);
+        return -1;
+    }
 
     write_reg_u8(UART_INTERRUPT_ENABLE, 0x00); // Disable all interrupts
     write_reg_u8(UART_LINE_CONTROL, 0x80);     // Enable DLAB (set baud rate divisor)
@@ -89,16 +139,60 @@ void init_uart(uint32_t freq, uint32_t baud)
     write_reg_u8(UART_LINE_CONTROL, 0x03);     // 8 bits, no parity, one stop bit
     write_reg_u8(UART_FIFO_CONTROL, 0xC7);     // Enable FIFO, clear them, with 14-byte threshold
     write_reg_u8(UART_MODEM_CONTROL, 0x20);    // Autoflow mode
+
+    uart_baud = actual;
+    uart_baud_error_ppm = error_ppm;
+#else
+    (void)freq;
+    uart_baud = baud;
+    uart_baud_error_ppm = 0;
+#endif
+    return 0;
+}
+
+uint32_t uart_get_baud(void)
+{
+    return uart_baud;
+}
+
+int32_t uart_get_baud_error_ppm(void)
+{
+    return uart_baud_error_ppm;
+}
+
+void print_uart_config(void)
+{
+    printf_uart("UART baud: %u (error %d ppm), console: %s\n", uart_baud, uart_baud_error_ppm, console_name());
+}
+
+// 等待发送FIFO和移位寄存器全部发送完毕
+void uart_flush(void)
+{
+#ifdef UART_TELEMETRY
+    uint64_t t0 = read_mcycle();
+    console_flush();
+    uart_telem.flush_cycles += read_mcycle() - t0;
+#else
+    console_flush();
+#endif
 }
 
 void print_uart(const char *str)
 {
+#ifdef CONSOLE_HAS_PUTS
+    console_puts(str);
+#ifdef UART_TELEMETRY
+    for (const char *p = str; *p; p++)
+        uart_telem.tx_bytes++;
+#endif
+#else
     const char *cur = &str[0];
     while (*cur != '\0')
     {
         print_uart_char((uint8_t)*cur);
         ++cur;
     }
+#endif
 }
 
 void print_uart_hex_32b(uint32_t data)
@@ -226,6 +320,10 @@ void load_uart(char *str, char terminator)
             }
             str[i++] = c;
         }
+        else
+        {
+            uart_idle();
+        }
     }
 }
 
@@ -236,8 +334,8 @@ void load_uart_32b(uint32_t *data)
     {
         uint8_t byte;
         uint8_t hex[2];
-        while (!load_uart_char(&hex[0])){}
-        while (!load_uart_char(&hex[1])){}
+        while (!load_uart_char(&hex[0])) uart_idle();
+        while (!load_uart_char(&hex[1])) uart_idle();
         if (hex[0] == '\n' || hex[1] == '\n')
             byte = 0;
         else
@@ -253,8 +351,8 @@ void load_uart_64b(uint64_t *data)
     {
         uint8_t byte;
         uint8_t hex[2];
-        while (!load_uart_char(&hex[0])){}
-        while (!load_uart_char(&hex[1])){}
+        while (!load_uart_char(&hex[0])) uart_idle();
+        while (!load_uart_char(&hex[1])) uart_idle();
         if (hex[0] == '\n' || hex[1] == '\n')
             byte = 0;
         else
@@ -266,40 +364,38 @@ void load_uart_64b(uint64_t *data)
 void load_uart_byte(uint8_t *byte)
 {
     uint8_t hex[2];
-    while (!load_uart_char(&hex[0])){}
-    while (!load_uart_char(&hex[1])){}
+    while (!load_uart_char(&hex[0])) uart_idle();
+    while (!load_uart_char(&hex[1])) uart_idle();
     if (hex[0] == '\n' || hex[1] == '\n')
         *byte = 0;
     else
         *byte = (hex_to_bin(hex[0]) << 4) | hex_to_bin(hex[1]);
 }
 
-void load_uart_timeout(char *str, char terminator, int max_len, uint32_t timeout)
+void load_uart_timeout(char *str, char terminator, int max_len, uint32_t timeout_ms)
 {
     uint8_t c;
     int i = 0;
-    int count = 0;
-    uint32_t timer = 0;
-    while (count < max_len && timer < timeout)
+    // 连结尾的 '\0' 都放不下，不能写 str
+    if (max_len <= 0)
+        return;
+    while (1)
     {
-        if (load_uart_char(&c))
+        if (i >= max_len - 1)
         {
-            if (c == terminator)
-            {
-                str[i] = '\0';
-                break;
-            }
-            str[i++] = c;
-            timer = 0;
-            count++;
-        }
-        else
-            timer++;
-        if (count == max_len)
             print_uart("ERROR! Maximum length reached, terminating input.\n");
-        if (timer == timeout)
+            break;
+        }
+        if (!load_uart_char_timeout(&c, (uint64_t)timeout_ms * 1000))
+        {
             print_uart("ERROR! Input timed out, terminating input.\n");
+            break;
+        }
+        if (c == terminator)
+            break;
+        str[i++] = c;
     }
+    str[i] = '\0';
 }
 
 void printf_uart(const char* format, ...)
@@ -312,28 +408,39 @@ void printf_uart(const char* format, ...)
     while (*p != '\0') {
         if (*p == '%' && *(p + 1) != '\0') {
             p++; // 跳过 '%'
+            // 'l' / 'll' 长度修饰符：按64位读取参数
+            int is_long = 0;
+            while (*p == 'l' && *(p + 1) != '\0') {
+                is_long = 1;
+                p++;
+            }
             switch (*p) {
                 case 'd':
                 case 'i': {
                     // 有符号整数
-                    int32_t val = va_arg(args, int32_t);
+                    int64_t val = is_long ? va_arg(args, int64_t) : va_arg(args, int32_t);
+                    uint64_t mag = (uint64_t)val;
                     if (val < 0) {
                         print_uart_char('-');
-                        val = -val;
+                        mag = -mag;
                     }
-                    print_uart_dec_32b((uint32_t)val);
+                    print_uart_dec_64b(mag);
                     break;
                 }
                 case 'u': {
                     // 无符号整数
-                    uint32_t val = va_arg(args, uint32_t);
-                    print_uart_dec_32b(val);
+                    if (is_long)
+                        print_uart_dec_64b(va_arg(args, uint64_t));
+                    else
+                        print_uart_dec_32b(va_arg(args, uint32_t));
                     break;
                 }
                 case 'x': {
                     // 十六进制整数
-                    uint32_t val = va_arg(args, uint32_t);
-                    print_uart_hex_32b(val);
+                    if (is_long)
+                        print_uart_hex_64b(va_arg(args, uint64_t));
+                    else
+                        print_uart_hex_32b(va_arg(args, uint32_t));
                     break;
                 }
                 case 'p': {
@@ -386,3 +493,89 @@ void printf_uart(const char* format, ...)
 
     va_end(args);
 }
+
+// 波特率协商（主机端见 utils/baud_negotiate.py），命令均为单字节：
+//   'S' u32 baud : 试用新波特率，回复 'K' 后切换，不支持则回复 'R'
+//   'P' u8 n ... : 在新波特率下原样回显 n 个字节
+//   'A'          : 确认新波特率可用
+//   'D'          : 协商结束
+// 试用阶段超时或收到其他字节时，双方都退回上一个可用的波特率
+#define NEGOTIATE_TRIAL_TIMEOUT_MS 500
+
+uint32_t uart_negotiate_baud(uint32_t freq, uint32_t timeout_ms)
+{
+    uint32_t good = uart_baud;
+
+#ifndef CONSOLE_16550
+    // 没有可调的波特率
+    (void)freq;
+    (void)timeout_ms;
+#else
+    uint8_t cmd;
+
+    print_uart("\n@BAUD?\n");
+
+    while (load_uart_char_timeout(&cmd, (uint64_t)timeout_ms * 1000))
+    {
+        if (cmd == 'D')
+            break;
+        if (cmd != 'S')
+            continue;
+
+        uint32_t baud = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            uint8_t b;
+            if (!load_uart_char_timeout(&b, (uint64_t)NEGOTIATE_TRIAL_TIMEOUT_MS * 1000))
+                return uart_baud;
+            baud |= (uint32_t)b << (i * 8);
+        }
+
+        uint32_t actual;
+        int32_t error_ppm;
+        if (uart_divisor(freq, baud, &actual, &error_ppm) == 0)
+        {
+            print_uart_char('R');
+            continue;
+        }
+
+        print_uart_char('K');
+        uart_flush();
+        init_uart(freq, baud);
+
+        int accepted = 0;
+        while (load_uart_char_timeout(&cmd, (uint64_t)NEGOTIATE_TRIAL_TIMEOUT_MS * 1000))
+        {
+            if (cmd == 'A')
+            {
+                accepted = 1;
+                break;
+            }
+            if (cmd != 'P')
+                break;
+
+            uint8_t n, b;
+            if (!load_uart_char_timeout(&n, (uint64_t)NEGOTIATE_TRIAL_TIMEOUT_MS * 1000))
+                break;
+            while (n--)
+            {
+                if (!load_uart_char_timeout(&b, (uint64_t)NEGOTIATE_TRIAL_TIMEOUT_MS * 1000))
+                    break;
+                print_uart_char(b);
+            }
+        }
+
+        if (accepted)
+        {
+            good = baud;
+        }
+        else
+        {
+            uart_flush();
+            init_uart(freq, good);
+        }
+    }
+#endif
+
+    return good;
+}
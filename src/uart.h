@@ -6,8 +6,12 @@
 #pragma once
 
 #include <stdint.h>
+#include "timer.h"
+#include "platform.h"
+#include "console.h"
 
-#define UART_BASE 0x10000000
+// 16550 寄存器，仅 CONSOLE_16550 时 init_uart 等函数会访问
+#define UART_BASE CONSOLE_BASE
 
 #define UART_RBR UART_BASE + 0
 #define UART_THR UART_BASE + 0
@@ -21,7 +25,35 @@
 #define UART_DLAB_LSB UART_BASE + 0
 #define UART_DLAB_MSB UART_BASE + 4
 
-void init_uart(uint32_t freq, uint32_t baud);
+#define UART_LSR_DR   0x01
+#define UART_LSR_THRE 0x20
+#define UART_LSR_TEMT 0x40
+
+// 实际波特率与目标的最大允许偏差（ppm），超出则拒绝配置
+#ifndef UART_MAX_BAUD_ERROR_PPM
+#define UART_MAX_BAUD_ERROR_PPM 25000
+#endif
+
+// 成功返回0；分频系数越界或误差过大返回-1，此时保持原配置不变并（按原配置）输出原因，
+// 调用者检查返回值
+// 非 16550 后端没有波特率，只记录 baud 供 uart_get_baud 返回
+int init_uart(uint32_t freq, uint32_t baud);
+
+uint32_t uart_get_baud(void);
+
+int32_t uart_get_baud_error_ppm(void);
+
+void print_uart_config(void);
+
+// 等待已写出的字符全部发送完毕
+void uart_flush(void);
+
+// 与 utils/baud_negotiate.py 握手，逐级提升波特率，返回最终使用的波特率
+// 仅 CONSOLE_16550 有效，其他后端直接返回当前波特率
+uint32_t uart_negotiate_baud(uint32_t freq, uint32_t timeout_ms);
+
+// 等待 UART 收发时反复调用的钩子（弱定义，默认为空），链接 sched.c 时改为让出处理器
+void uart_idle(void);
 
 void print_uart(const char* str);
 
@@ -51,7 +83,10 @@ void load_uart_byte(uint8_t *byte);
 
 int load_uart_char(uint8_t *res);
 
-void load_uart_timeout(char *str, char terminator, int max_len, uint32_t timeout);
+int load_uart_char_timeout(uint8_t *res, uint64_t timeout_us);
+
+// timeout_ms 为两个字符之间允许的最长间隔；max_len 包含结尾的 '\0'，不大于 0 时不读取也不写 str
+void load_uart_timeout(char *str, char terminator, int max_len, uint32_t timeout_ms);
 
 void printf_uart(const char* format, ...);
 
@@ -59,6 +94,8 @@ void printf_uart(const char* format, ...);
 // - %d, %i : 有符号32位整数（十进制），负数会显示负号
 // - %u     : 无符号32位整数（十进制格式，8位）
 // - %x     : 无符号32位整数（十六进制格式，8位）
+// - %ld, %li, %lu, %lx : 对应的64位版本（int64_t/uint64_t），十六进制为16位
+//   类型检查版本见 uart_fmt.h 中的 print_uart_fmt()
 // - %p     : 指针地址（64位，格式为0x+16位十六进制）
 // - %c     : 单个字符
 // - %s     : 字符串（C风格，以\0结尾）
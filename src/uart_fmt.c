@@ -0,0 +1,66 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Type-Checked UART Formatting Front End
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "uart_fmt.h"
+#include "uart.h"
+#include <stdint.h>
+#include <stddef.h>
+
+static const char hex_digits[16] = {
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
+
+void uart_emit_str(const char *s)
+{
+    print_uart(s != NULL ? s : "(null)");
+}
+
+void uart_emit_char(char c)
+{
+    print_uart_char(c);
+}
+
+void uart_emit_chr(uart_chr_t c)
+{
+    print_uart_char(c.c);
+}
+
+// 十进制转换由 isa_utoa 按核的扩展选择实现（src/isa.c）
+void uart_emit_u64(uint64_t v)
+{
+    char buf[21];
+    isa_utoa(v, buf);
+    print_uart(buf);
+}
+
+void uart_emit_i64(int64_t v)
+{
+    if (v < 0) {
+        print_uart_char('-');
+        uart_emit_u64(-(uint64_t)v);
+    } else {
+        uart_emit_u64(v);
+    }
+}
+
+void uart_emit_hex(uart_hex_t h)
+{
+    for (int i = h.digits - 1; i >= 0; i--)
+        print_uart_char(hex_digits[(h.value >> (i * 4)) & 0xf]);
+}
+
+void uart_emit_bin(uart_bin_t b)
+{
+    for (int i = b.bits - 1; i >= 0; i--) {
+        print_uart_char('0' + ((b.value >> i) & 1));
+        if (i > 0 && i % 4 == 0)
+            print_uart_char('_');
+    }
+}
+
+void uart_emit_ptr(const void *p)
+{
+    print_uart("0x");
+    uart_emit_hex((uart_hex_t){ (uintptr_t)p, 16 });
+}
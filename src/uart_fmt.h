@@ -0,0 +1,88 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     Type-Checked UART Formatting Front End
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include "uart.h"
+// uart_fmt.c 的十进制输出使用 isa_utoa，在头文件中包含才能让 isa.c 参与链接；
+// 第一次输出数字时 isa.c 才检测扩展，只打印字符串的程序不做试探
+#include "isa.h"
+
+// 用法：
+//   print_uart_fmt("addr ", PTR(p), " = ", HEX(v), " (", v, ")\n");
+// 每个参数在编译期按类型（_Generic）展开为一次输出函数调用，运行时不解析格式串；
+// 不支持的类型直接编译报错，64位整数不会再被截断。
+//   字符串(char*)     -> 原样输出          char      -> 单个字符
+//   有符号整数        -> 十进制（带负号）   无符号整数 -> 十进制
+//   void*             -> 0x + 16位十六进制
+//   HEX(x)/BYTE(x)/BIN(x)/CHR(c)/PTR(p) 指定其他格式
+// 注意 'A' 这样的字符字面量在C中是 int，需写成 CHR('A')
+
+typedef struct { uint64_t value; uint8_t digits; } uart_hex_t;
+typedef struct { uint64_t value; uint8_t bits; } uart_bin_t;
+typedef struct { char c; } uart_chr_t;
+
+#define HEX(x)  ((uart_hex_t){ (uint64_t)(x), sizeof(x) * 2 })
+#define BYTE(x) ((uart_hex_t){ (uint8_t)(x), 2 })
+#define BIN(x)  ((uart_bin_t){ (uint64_t)(x), sizeof(x) * 8 })
+#define CHR(c)  ((uart_chr_t){ (char)(c) })
+#define PTR(p)  ((const void *)(p))
+
+void uart_emit_str(const char *s);
+void uart_emit_char(char c);
+void uart_emit_chr(uart_chr_t c);
+void uart_emit_i64(int64_t v);
+void uart_emit_u64(uint64_t v);
+void uart_emit_hex(uart_hex_t h);
+void uart_emit_bin(uart_bin_t b);
+void uart_emit_ptr(const void *p);
+
+#define UART_EMIT(x) _Generic((x),          \
+    char *:             uart_emit_str,      \
+    const char *:       uart_emit_str,      \
+    char:               uart_emit_char,     \
+    signed char:        uart_emit_i64,      \
+    short:              uart_emit_i64,      \
+    int:                uart_emit_i64,      \
+    long:               uart_emit_i64,      \
+    long long:          uart_emit_i64,      \
+    unsigned char:      uart_emit_u64,      \
+    unsigned short:     uart_emit_u64,      \
+    unsigned int:       uart_emit_u64,      \
+    unsigned long:      uart_emit_u64,      \
+    unsigned long long: uart_emit_u64,      \
+    void *:             uart_emit_ptr,      \
+    const void *:       uart_emit_ptr,      \
+    uart_hex_t:         uart_emit_hex,      \
+    uart_bin_t:         uart_emit_bin,      \
+    uart_chr_t:         uart_emit_chr)(x);
+
+#define UART_FMT_CAT_(a, b) a##b
+#define UART_FMT_CAT(a, b)  UART_FMT_CAT_(a, b)
+#define UART_FMT_NARGS_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, N, ...) N
+#define UART_FMT_NARGS(...) \
+    UART_FMT_NARGS_(__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1)
+
+#define UART_FMT_1(x)       UART_EMIT(x)
+#define UART_FMT_2(x, ...)  UART_EMIT(x) UART_FMT_1(__VA_ARGS__)
+#define UART_FMT_3(x, ...)  UART_EMIT(x) UART_FMT_2(__VA_ARGS__)
+#define UART_FMT_4(x, ...)  UART_EMIT(x) UART_FMT_3(__VA_ARGS__)
+#define UART_FMT_5(x, ...)  UART_EMIT(x) UART_FMT_4(__VA_ARGS__)
+#define UART_FMT_6(x, ...)  UART_EMIT(x) UART_FMT_5(__VA_ARGS__)
+#define UART_FMT_7(x, ...)  UART_EMIT(x) UART_FMT_6(__VA_ARGS__)
+#define UART_FMT_8(x, ...)  UART_EMIT(x) UART_FMT_7(__VA_ARGS__)
+#define UART_FMT_9(x, ...)  UART_EMIT(x) UART_FMT_8(__VA_ARGS__)
+#define UART_FMT_10(x, ...) UART_EMIT(x) UART_FMT_9(__VA_ARGS__)
+#define UART_FMT_11(x, ...) UART_EMIT(x) UART_FMT_10(__VA_ARGS__)
+#define UART_FMT_12(x, ...) UART_EMIT(x) UART_FMT_11(__VA_ARGS__)
+#define UART_FMT_13(x, ...) UART_EMIT(x) UART_FMT_12(__VA_ARGS__)
+#define UART_FMT_14(x, ...) UART_EMIT(x) UART_FMT_13(__VA_ARGS__)
+#define UART_FMT_15(x, ...) UART_EMIT(x) UART_FMT_14(__VA_ARGS__)
+#define UART_FMT_16(x, ...) UART_EMIT(x) UART_FMT_15(__VA_ARGS__)
+
+#define print_uart_fmt(...) do { \
+    UART_FMT_CAT(UART_FMT_, UART_FMT_NARGS(__VA_ARGS__))(__VA_ARGS__) \
+} while (0)
@@ -5,6 +5,7 @@
 //////////////////////////////////////////////////////////////////////////////////
 
 #include "uart.h"
+#include "uart_fmt.h"
 #include <stdint.h>
 #include <stddef.h>
 
@@ -158,7 +159,7 @@ void test_load_uart_char() {
             char_count++;
         }
         // 简单延时，避免过度轮询
-        for (volatile int i = 0; i < 1000; i++);
+        delay_us(10);
     }
 }
 
@@ -284,9 +285,9 @@ void test_load_uart_timeout() {
     print_uart("Type something within 30 seconds (end with '*'):\n");
 
     char timeout_buffer[100];
-    uint32_t timeout = 50000000 * 30;    // 50MHz * 30 seconds
+    uint32_t timeout_ms = 30 * 1000;    // 30 seconds
 
-    load_uart_timeout(timeout_buffer, '*', sizeof(timeout_buffer), timeout);
+    load_uart_timeout(timeout_buffer, '*', sizeof(timeout_buffer), timeout_ms);
 
     print_uart("Result: \"");
     print_uart(timeout_buffer);
@@ -479,10 +480,32 @@ void test_printf_uart() {
     printf_uart("printf_uart test completed!\n");
 }
 
+// 测试64位格式和类型检查的 print_uart_fmt
+void test_print_uart_fmt() {
+    print_uart("=== Typed Format Tests ===\n");
+
+    uint64_t big = 0xFFFFFFFFFFFFFFFFULL;
+    int64_t neg = -1234567890123LL;
+    uint8_t byte = 0xAB;
+
+    printf_uart("printf %%lu: %lu, %%ld: %ld, %%lx: %lx\n", big, neg, big);
+
+    print_uart_fmt("fmt u64: ", big, ", i64: ", neg, ", i32: ", (int32_t)-42, "\n");
+    print_uart_fmt("fmt hex: ", HEX((uint32_t)0xDEADBEEF), " ", HEX(big), " byte: ", BYTE(byte), "\n");
+    print_uart_fmt("fmt bin: ", BIN(byte), ", char: ", CHR('Z'), ", ptr: ", PTR(0x80000000), "\n");
+    print_uart_fmt("fmt str: ", "Hello", " ", (const char*)NULL, "\n");
+}
+
 int main() {
     // 初始化UART
     print_uart("Initializing UART...\n");
-    init_uart(115000000, 115200);
+    if (init_uart(PLAT_CLK_FREQ, PLAT_UART_BAUD) != 0)
+        return 1;
+    init_timer();
+#ifdef UART_NEGOTIATE_BAUD
+    uart_negotiate_baud(PLAT_CLK_FREQ, 3000);
+#endif
+    print_uart_config();
 
     print_uart("\n");
     print_uart("========================================\n");
@@ -531,6 +554,7 @@ int main() {
 
     // in-house printf_uart function tests
     test_printf_uart();
+    test_print_uart_fmt();
 
     print_uart("\n");
     print_uart("========================================\n");
@@ -0,0 +1,60 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     UART Backpressure Telemetry (make UART_TELEMETRY=1)
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "uart_telemetry.h"
+#include "console.h"
+#include "exit.h"
+#include "result.h"
+#include "uart.h"
+#include <stdint.h>
+
+uart_telemetry_t uart_telem;
+
+void uart_telemetry_get(uart_telemetry_t *t)
+{
+    *t = uart_telem;
+}
+
+void uart_telemetry_reset(void)
+{
+    uart_telem = (uart_telemetry_t){0};
+    uart_telem.start = read_mcycle();
+}
+
+void uart_telemetry_report(void)
+{
+    uart_telemetry_t t;
+    uart_telemetry_get(&t);
+    uint64_t elapsed = read_mcycle() - t.start;
+    uint64_t permille = elapsed ? t.tx_stall_cycles * 1000 / elapsed : 0;
+    uint32_t errors = t.rx_overrun + t.rx_parity + t.rx_framing + t.rx_break;
+
+    printf_uart("UART telemetry (%s): tx %lu bytes, rx %lu bytes in %lu cycles\n",
+                console_name(), t.tx_bytes, t.rx_bytes, elapsed);
+    printf_uart("  tx stalled %lu times, %lu cycles (%lu.%lu%% of run), avg %lu, max %lu\n",
+                t.tx_stalls, t.tx_stall_cycles, permille / 10, permille % 10,
+                t.tx_stalls ? t.tx_stall_cycles / t.tx_stalls : 0, t.tx_stall_max);
+    printf_uart("  flush: %lu cycles\n", t.flush_cycles);
+    printf_uart("  rx errors: overrun %u, parity %u, framing %u, break %u\n",
+                t.rx_overrun, t.rx_parity, t.rx_framing, t.rx_break);
+#if defined(CONSOLE_HAS_TX_LEVEL)
+    printf_uart("  peak occupancy: tx %u, rx %u\n", t.tx_peak, t.rx_peak);
+#elif defined(CONSOLE_HAS_RX_LEVEL)
+    printf_uart("  peak occupancy: rx %u (backlog)\n", t.rx_peak);
+#else
+    printf_uart("  peak occupancy: rx %u\n", t.rx_peak);
+#endif
+    result_emit("uart.tx_stall", t.tx_stall_cycles, 0, t.tx_bytes, errors);
+}
+
+#ifdef UART_TELEMETRY
+// make UART_TELEMETRY=1 时注册退出钩子（由 startup.S 执行 .init_array）
+__attribute__((constructor))
+static void uart_telemetry_autostart(void)
+{
+    uart_telemetry_reset();
+    atexit(uart_telemetry_report);
+}
+#endif
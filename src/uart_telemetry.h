@@ -0,0 +1,87 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Author:          Mingxuan Li
+// Description:     UART Backpressure Telemetry (make UART_TELEMETRY=1)
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include "csr.h"
+
+// 定义 UART_TELEMETRY 时 uart.c / console.h 在收发路径上更新计数，并在程序退出时输出报告；
+// 未定义时计数保持为 0，没有额外开销。
+// 发送等待周期包含等待期间 uart_idle()（如调度器切换到其他任务）所用的时间。
+
+typedef struct {
+    uint64_t start;             // 计数起点的 mcycle（程序启动或 uart_telemetry_reset）
+    uint64_t tx_bytes;
+    uint64_t rx_bytes;
+    uint64_t tx_stalls;         // 写入前发送端未就绪（16550 为 THRE = 0）的次数
+    uint64_t tx_stall_cycles;   // 等待发送端就绪的总周期
+    uint64_t tx_stall_max;      // 单次最长等待
+    uint64_t flush_cycles;      // uart_flush 等待发送完毕的总周期
+    uint32_t rx_overrun;        // LSR.OE，接收 FIFO 满后丢失字符
+    uint32_t rx_parity;         // LSR.PE
+    uint32_t rx_framing;        // LSR.FE
+    uint32_t rx_break;          // LSR.BI
+    uint32_t tx_peak;           // 发送 FIFO 最大占用，仅 jtag 后端可读出
+    uint32_t rx_peak;           // 接收端积压：ring 后端为读出的最大占用，其他后端为连续读到的最多字节数（积压的下限）
+    uint32_t rx_run;            // 当前连续读到的字节数
+    uint32_t reserved;
+} uart_telemetry_t;
+
+extern uart_telemetry_t uart_telem;
+
+// 复制当前计数
+void uart_telemetry_get(uart_telemetry_t *t);
+
+// 清零并以当前 mcycle 为起点
+void uart_telemetry_reset(void);
+
+// 输出统计和一条 uart.tx_stall 的 @RESULT 记录（先取快照，不包含报告本身的输出）
+void uart_telemetry_report(void);
+
+// 以下由驱动调用
+
+// 16550 读 LSR 会清除错误位，所以每次读 LSR 都要记录
+static inline void uart_telemetry_lsr(uint8_t lsr)
+{
+    if (!(lsr & 0x1e))
+        return;
+    uart_telem.rx_overrun += (lsr >> 1) & 1;
+    uart_telem.rx_parity += (lsr >> 2) & 1;
+    uart_telem.rx_framing += (lsr >> 3) & 1;
+    uart_telem.rx_break += (lsr >> 4) & 1;
+}
+
+static inline void uart_telemetry_stall(uint64_t cycles)
+{
+    uart_telem.tx_stalls++;
+    uart_telem.tx_stall_cycles += cycles;
+    if (cycles > uart_telem.tx_stall_max)
+        uart_telem.tx_stall_max = cycles;
+}
+
+static inline void uart_telemetry_tx_level(uint32_t level)
+{
+    if (level > uart_telem.tx_peak)
+        uart_telem.tx_peak = level;
+}
+
+// 能读出接收缓冲区占用的后端（CONSOLE_HAS_RX_LEVEL）在每次读取前记录，代替 uart_telemetry_rx
+static inline void uart_telemetry_rx_level(uint32_t level)
+{
+    if (level > uart_telem.rx_peak)
+        uart_telem.rx_peak = level;
+}
+
+static inline void uart_telemetry_rx(int got)
+{
+    if (!got) {
+        uart_telem.rx_run = 0;
+        return;
+    }
+    uart_telem.rx_bytes++;
+    if (++uart_telem.rx_run > uart_telem.rx_peak)
+        uart_telem.rx_peak = uart_telem.rx_run;
+}
@@ -0,0 +1,294 @@
+##################################################################################
+# Author:          Mingxuan Li
+# Description:     Static instruction-mix and hot-pattern analysis of build/$(MAIN).asm
+#                  (objdump -D output): per-function class counts, loop checks, diff
+##################################################################################
+
+import argparse
+import json
+import re
+import sys
+
+FUNC_RE = re.compile(r'^([0-9a-f]+) <(.+)>:$')
+INSN_RE = re.compile(r'^\s*([0-9a-f]+):\s+([0-9a-f]{4,8})\s+(\S+)\s*(.*)$')
+SECTION_RE = re.compile(r'^Disassembly of section (\S+):')
+TARGET_RE = re.compile(r'\b([0-9a-f]+) <')
+MEM_RE = re.compile(r'(-?\d+)\((\w+)\)')
+
+CLASSES = ('load', 'store', 'mul', 'div', 'branch', 'jump', 'csr', 'system', 'amo', 'vector', 'alu')
+
+LOADS = {'lb', 'lh', 'lw', 'ld', 'lbu', 'lhu', 'lwu', 'c.lw', 'c.ld', 'c.lwsp', 'c.ldsp', 'flw', 'fld'}
+STORES = {'sb', 'sh', 'sw', 'sd', 'c.sw', 'c.sd', 'c.swsp', 'c.sdsp', 'fsw', 'fsd'}
+MULS = {'mul', 'mulh', 'mulhsu', 'mulhu', 'mulw'}
+DIVS = {'div', 'divu', 'rem', 'remu', 'divw', 'divuw', 'remw', 'remuw'}
+BRANCHES = {'beq', 'bne', 'blt', 'bge', 'bltu', 'bgeu', 'beqz', 'bnez', 'blez', 'bgez', 'bltz', 'bgtz',
+            'bgt', 'ble', 'bgtu', 'bleu', 'c.beqz', 'c.bnez'}
+JUMPS = {'jal', 'jalr', 'j', 'jr', 'ret', 'call', 'tail', 'c.j', 'c.jal', 'c.jr', 'c.jalr'}
+SYSTEM = {'ecall', 'ebreak', 'mret', 'sret', 'wfi', 'fence', 'fence.i', 'sfence.vma', 'c.ebreak'}
+BYTE_MEM = {'lb', 'lbu', 'sb'}
+
+# 外设地址区间（与 src/ 中的驱动保持一致）
+MMIO_RANGES = (
+    (0x02000000, 0x02010000, 'CLINT'),
+    (0x10000000, 0x10001000, 'UART'),
+    (0xe0000000, 0xe0001000, 'DRAMCTL'),
+)
+
+
+def classify(mnemonic):
+    m = mnemonic.split('.')[0] if mnemonic.startswith(('amo', 'lr.', 'sc.')) else mnemonic
+    if mnemonic in LOADS:
+        return 'load'
+    if mnemonic in STORES:
+        return 'store'
+    if mnemonic in MULS:
+        return 'mul'
+    if mnemonic in DIVS:
+        return 'div'
+    if mnemonic in BRANCHES:
+        return 'branch'
+    if mnemonic in JUMPS:
+        return 'jump'
+    if mnemonic.startswith('csr') or mnemonic.startswith('rd') and mnemonic[2:] in ('cycle', 'time', 'instret'):
+        return 'csr'
+    if mnemonic in SYSTEM:
+        return 'system'
+    if m.startswith('amo') or m in ('lr', 'sc'):
+        return 'amo'
+    if mnemonic.startswith('v'):
+        return 'vector'
+    return 'alu'
+
+
+def mmio_name(value):
+    for lo, hi, name in MMIO_RANGES:
+        if lo <= value < hi:
+            return name
+    return None
+
+
+def parse_asm(path):
+    """返回 {函数名: {'addr': 起始地址, 'bytes': 编码总字节数, 'insns': [(addr, mnemonic, operands)]}}，
+    只看 .text 段；字节数按 objdump 的编码列累加，RVC 指令为 2 字节"""
+    funcs = {}
+    cur = None
+    in_text = False
+    with open(path, errors='replace') as f:
+        for line in f:
+            line = line.rstrip('\n')
+            m = SECTION_RE.match(line)
+            if m:
+                in_text = m.group(1).startswith('.text')
+                cur = None
+                continue
+            if line.startswith('Contents of section'):
+                in_text = False
+                cur = None
+                continue
+            if not in_text:
+                continue
+            m = FUNC_RE.match(line)
+            if m:
+                cur = {'addr': int(m.group(1), 16), 'bytes': 0, 'insns': []}
+                funcs[m.group(2)] = cur
+                continue
+            m = INSN_RE.match(line)
+            if m and cur is not None:
+                cur['insns'].append((int(m.group(1), 16), m.group(3), m.group(4)))
+                cur['bytes'] += len(m.group(2)) // 2
+    return funcs
+
+
+def find_loops(insns):
+    """向后跳转（分支或 j）即一个循环：返回 [(循环头地址, 回跳指令地址)]"""
+    if not insns:
+        return []
+    lo, hi = insns[0][0], insns[-1][0]
+    loops = []
+    for addr, mnem, ops in insns:
+        if classify(mnem) not in ('branch', 'jump') or mnem in ('ret', 'jr', 'jalr', 'call', 'tail', 'jal'):
+            continue
+        m = TARGET_RE.search(ops)
+        if not m:
+            continue
+        target = int(m.group(1), 16)
+        if lo <= target <= addr <= hi:
+            loops.append((target, addr))
+    return loops
+
+
+def loop_depth(addr, loops):
+    return sum(1 for head, tail in loops if head <= addr <= tail)
+
+
+def track_mmio_regs(insns):
+    """粗略跟踪 lui/li 装入外设基址的寄存器，返回 {指令地址: {寄存器: 外设名}}（顺序扫描，不做控制流合并）"""
+    regs = {}
+    state = {}
+    for addr, mnem, ops in insns:
+        regs[addr] = dict(state)
+        parts = [p.strip() for p in ops.split('#')[0].split(',')]
+        if not parts or not parts[0]:
+            continue
+        rd = parts[0]
+        if mnem == 'lui' and len(parts) == 2:
+            value = int(parts[1], 0) << 12 & 0xffffffff
+            name = mmio_name(value)
+            if name:
+                state[rd] = (name, value)
+            else:
+                state.pop(rd, None)
+        elif mnem == 'li' and len(parts) == 2:
+            try:
+                value = int(parts[1], 0) & 0xffffffffffffffff
+            except ValueError:
+                value = None
+            name = mmio_name(value) if value is not None else None
+            if name:
+                state[rd] = (name, value)
+            else:
+                state.pop(rd, None)
+        elif mnem == 'slli' and len(parts) == 3 and parts[1] == rd and rd in state:
+            name, value = state[rd]
+            value = value << int(parts[2], 0) & 0xffffffffffffffff
+            if mmio_name(value):
+                state[rd] = (mmio_name(value), value)
+            else:
+                state.pop(rd)
+        elif mnem == 'addi' and len(parts) == 3 and rd in state and parts[1] == rd:
+            name, value = state[rd]
+            state[rd] = (name, value + int(parts[2], 0))
+        elif classify(mnem) not in ('store', 'branch') and rd in state:
+            state.pop(rd)
+        if classify(mnem) == 'jump' and mnem in ('call', 'jal', 'jalr'):
+            state.clear()
+    return regs
+
+
+def analyze_function(func):
+    insns = func['insns']
+    counts = dict.fromkeys(CLASSES, 0)
+    for _, mnem, _ in insns:
+        counts[classify(mnem)] += 1
+
+    loops = find_loops(insns)
+    regs = track_mmio_regs(insns)
+    findings = []
+    for addr, mnem, ops in insns:
+        cls = classify(mnem)
+        depth = loop_depth(addr, loops)
+        if cls == 'div' and depth:
+            kind = 'div-in-nested-loop' if depth > 1 else 'div-in-loop'
+            findings.append({'kind': kind, 'addr': addr, 'insn': f'{mnem} {ops}'.strip(), 'depth': depth})
+        if cls in ('load', 'store'):
+            m = MEM_RE.search(ops)
+            base = regs.get(addr, {}).get(m.group(2)) if m else None
+            if base and mnem in BYTE_MEM and depth:
+                findings.append({'kind': 'byte-mmio-in-loop', 'addr': addr,
+                                 'insn': f'{mnem} {ops}'.strip(), 'device': base[0], 'depth': depth})
+        if cls == 'csr' and depth and 'mcycle' not in ops and 'minstret' not in ops:
+            findings.append({'kind': 'csr-in-loop', 'addr': addr, 'insn': f'{mnem} {ops}'.strip(), 'depth': depth})
+
+    return {'addr': func['addr'], 'insns': len(insns), 'bytes': func['bytes'],
+            'classes': counts, 'loops': len(loops), 'findings': findings}
+
+
+def analyze(path):
+    if path.endswith('.json'):
+        with open(path) as f:
+            return json.load(f)
+    return {name: analyze_function(func) for name, func in parse_asm(path).items()}
+
+
+def totals(result):
+    t = dict.fromkeys(CLASSES, 0)
+    for r in result.values():
+        for c in CLASSES:
+            t[c] += r['classes'][c]
+    return t
+
+
+def print_report(result, top, out=sys.stdout):
+    header = f'{"function":<32} {"insns":>6} ' + ' '.join(f'{c[:6]:>6}' for c in CLASSES) + f' {"loops":>5}'
+    print(header, file=out)
+    ranked = sorted(result.items(), key=lambda kv: -kv[1]['insns'])
+    for name, r in ranked[:top] if top else ranked:
+        row = ' '.join(f'{r["classes"][c]:>6}' for c in CLASSES)
+        print(f'{name[:32]:<32} {r["insns"]:>6} {row} {r["loops"]:>5}', file=out)
+    t = totals(result)
+    total = sum(t.values())
+    print(f'{"TOTAL":<32} {total:>6} ' + ' '.join(f'{t[c]:>6}' for c in CLASSES), file=out)
+    if total:
+        print('mix: ' + ', '.join(f'{c} {100.0 * t[c] / total:.1f}%' for c in CLASSES if t[c]), file=out)
+
+    flagged = [(name, f) for name, r in result.items() for f in r['findings']]
+    if flagged:
+        print(f'\n{len(flagged)} finding(s):', file=out)
+        for name, f in sorted(flagged, key=lambda x: (x[1]['kind'], x[0], x[1]['addr'])):
+            extra = f' [{f["device"]}]' if 'device' in f else ''
+            print(f'  {f["kind"]:<20} {name}+0x{f["addr"] - result[name]["addr"]:x}  '
+                  f'{f["insn"]}{extra} (loop depth {f["depth"]})', file=out)
+    else:
+        print('\nNo findings.', file=out)
+
+
+def print_diff(old, new, out=sys.stdout):
+    names = sorted(set(old) | set(new))
+    rows = []
+    for name in names:
+        a = old.get(name)
+        b = new.get(name)
+        if a is None:
+            rows.append((name, 0, b['insns'], 'added'))
+        elif b is None:
+            rows.append((name, a['insns'], 0, 'removed'))
+        else:
+            changed = [f'{c} {b["classes"][c] - a["classes"][c]:+d}' for c in CLASSES
+                       if b['classes'][c] != a['classes'][c]]
+            fa = len(a['findings'])
+            fb = len(b['findings'])
+            if fb != fa:
+                changed.append(f'findings {fb - fa:+d}')
+            if changed:
+                rows.append((name, a['insns'], b['insns'], ', '.join(changed)))
+    print(f'{"function":<32} {"old":>6} {"new":>6} {"delta":>6}  classes', file=out)
+    for name, a, b, what in sorted(rows, key=lambda r: -abs(r[2] - r[1])):
+        print(f'{name[:32]:<32} {a:>6} {b:>6} {b - a:>+6}  {what}', file=out)
+    ta, tb = totals(old), totals(new)
+    sa, sb = sum(ta.values()), sum(tb.values())
+    print(f'{"TOTAL":<32} {sa:>6} {sb:>6} {sb - sa:>+6}  ' +
+          ', '.join(f'{c} {tb[c] - ta[c]:+d}' for c in CLASSES if tb[c] != ta[c]), file=out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Instruction mix and hot-pattern report for objdump output')
+    parser.add_argument('asm', help='build/$(MAIN).asm (or a JSON file written by --json)')
+    parser.add_argument('--diff', metavar='BASE', help='compare against another .asm or .json (BASE is the old build)')
+    parser.add_argument('--json', help='also write the analysis to this JSON file (usable as a later --diff base)')
+    parser.add_argument('--top', type=int, default=25, help='functions to list, largest first (0 = all)')
+    parser.add_argument('--function', action='append', help='only report these functions')
+    parser.add_argument('--strict', action='store_true', help='exit non-zero if there are findings')
+    args = parser.parse_args()
+
+    result = analyze(args.asm)
+    # 先读基准，--json 与 --diff 指向同一文件时比较的是上一次的结果
+    base = analyze(args.diff) if args.diff else None
+    if args.function:
+        result = {k: v for k, v in result.items() if k in args.function}
+        if base is not None:
+            base = {k: v for k, v in base.items() if k in args.function}
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump(result, f, indent=1)
+
+    if base is not None:
+        print_diff(base, result)
+    else:
+        print_report(result, args.top)
+
+    if args.strict and any(r['findings'] for r in result.values()):
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,125 @@
+##################################################################################
+# Author:          Mingxuan Li
+# Description:     Host side of uart_negotiate_baud(): step the link to the
+#                  fastest baud rate that reliably round-trips a test pattern
+##################################################################################
+
+import argparse
+import random
+import struct
+import sys
+import time
+
+DEFAULT_RATES = [230400, 460800, 921600, 1000000, 1500000, 2000000, 3000000, 4000000]
+
+# 与 uart.c 中 NEGOTIATE_TRIAL_TIMEOUT_MS 保持一致
+TRIAL_TIMEOUT = 0.5
+
+
+def wait_for_request(port, timeout):
+    # 等待目标端发出的 "@BAUD?" 请求
+    deadline = time.time() + timeout
+    window = b''
+    while time.time() < deadline:
+        c = port.read(1)
+        if not c:
+            continue
+        window = (window + c)[-6:]
+        if window == b'@BAUD?':
+            port.read(1)    # 行尾的 '\n'
+            return True
+    return False
+
+
+def make_pattern(rng, size):
+    # 固定的边界字节加随机字节
+    fixed = bytes([0x00, 0xFF, 0x55, 0xAA, 0x0F, 0xF0, 0x01, 0x80])
+    rand = bytes(rng.randrange(256) for _ in range(size - len(fixed)))
+    return fixed + rand
+
+
+def try_rate(port, baud, good, rounds, size, rng):
+    port.write(b'S' + struct.pack('<I', baud))
+    reply = port.read(1)
+    if reply == b'R':
+        print(f'  {baud:>8}: rejected by target (divisor error too large)')
+        return None
+    if reply != b'K':
+        raise RuntimeError(f'unexpected reply {reply!r} to rate request')
+
+    time.sleep(0.02)
+    port.baudrate = baud
+    port.reset_input_buffer()
+
+    for _ in range(rounds):
+        pattern = make_pattern(rng, size)
+        port.write(b'P' + bytes([len(pattern)]) + pattern)
+        echo = port.read(len(pattern))
+        if echo != pattern:
+            errors = sum(a != b for a, b in zip(echo, pattern)) + len(pattern) - len(echo)
+            print(f'  {baud:>8}: FAILED ({errors} bad bytes), falling back to {good}')
+            # 等目标端超时回退后再切回原波特率
+            time.sleep(TRIAL_TIMEOUT * 2)
+            port.baudrate = good
+            port.reset_input_buffer()
+            return False
+
+    port.write(b'A')
+    port.flush()
+    print(f'  {baud:>8}: ok ({rounds} x {size} bytes)')
+    return True
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Negotiate the fastest reliable UART baud rate with the target')
+    parser.add_argument('port', help='serial port, e.g. /dev/ttyUSB0')
+    parser.add_argument('--baud', type=int, default=115200, help='initial baud rate (PLAT_UART_BAUD)')
+    parser.add_argument('--rates', help='comma-separated candidate rates, ascending')
+    parser.add_argument('--rounds', type=int, default=8, help='pattern round trips per candidate rate')
+    parser.add_argument('--size', type=int, default=255, help='bytes per pattern (max 255)')
+    parser.add_argument('--wait', type=float, default=30.0, help='seconds to wait for the target request')
+    parser.add_argument('--monitor', action='store_true', help='print target output after negotiation')
+
+    args = parser.parse_args()
+
+    try:
+        import serial
+    except ImportError:
+        sys.exit('Error: baud_negotiate.py requires pyserial (pip install pyserial)')
+
+    rates = [int(r) for r in args.rates.split(',')] if args.rates else DEFAULT_RATES
+    rates = [r for r in rates if r > args.baud]
+    size = max(8, min(args.size, 255))
+    rng = random.Random(0)
+
+    port = serial.Serial(args.port, args.baud, timeout=TRIAL_TIMEOUT, rtscts=True)
+    print(f'Waiting for target on {args.port} at {args.baud} baud...')
+    if not wait_for_request(port, args.wait):
+        sys.exit('Error: no negotiation request from target')
+
+    good = args.baud
+    for baud in rates:
+        result = try_rate(port, baud, good, args.rounds, size, rng)
+        if result:
+            good = baud
+        elif result is False:
+            break
+
+    port.write(b'D')
+    port.flush()
+    print(f'Negotiated baud rate: {good} ({good / args.baud:.1f}x)')
+
+    if args.monitor:
+        port.timeout = 0.1
+        try:
+            while True:
+                data = port.read(4096)
+                if data:
+                    sys.stdout.write(data.decode(errors='replace'))
+                    sys.stdout.flush()
+        except KeyboardInterrupt:
+            pass
+
+
+if __name__ == '__main__':
+    main()
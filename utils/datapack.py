@@ -0,0 +1,279 @@
+##################################################################################
+# Author:          Mingxuan Li
+# Description:     Pack the datasets listed in data/manifest (binary, CSV, .npy)
+#                  into an assembler file of .incbin objects plus a C header
+##################################################################################
+
+# manifest 每行一个数据集，# 开头为注释：
+#   <name>  <file>  [type=i16] [section=custom|dram|rodata] [align=64] [compress=lz4]
+# 文件路径相对于 manifest 所在目录。输出到 --out-dir：
+#   <name>.bin    转换后（或压缩后）的内容
+#   datasets.S    每个数据集一个 .incbin 对象 ds_<name>，以及 dataset_table[]（src/dataset.h）
+#   datasets.h    符号、元素个数、字节数和 DATASET_<NAME> 下标
+
+import argparse
+import ast
+import csv
+import os
+import re
+import struct
+import sys
+import zlib
+
+from lz4pack import compress
+
+# 元素类型：C 类型, struct 格式, .npy descr（不含字节序）
+TYPES = {
+    'u8':  ('uint8_t',  'B', 'u1'),
+    'i8':  ('int8_t',   'b', 'i1'),
+    'u16': ('uint16_t', 'H', 'u2'),
+    'i16': ('int16_t',  'h', 'i2'),
+    'u32': ('uint32_t', 'I', 'u4'),
+    'i32': ('int32_t',  'i', 'i4'),
+    'u64': ('uint64_t', 'Q', 'u8'),
+    'i64': ('int64_t',  'q', 'i8'),
+    'f32': ('float',    'f', 'f4'),
+    'f64': ('double',   'd', 'f8'),
+}
+NPY_TYPES = {v[2]: k for k, v in TYPES.items()}
+
+# section= 对应的输入段：custom 为 SPM 中的 .custom_data（0x30000000），
+# dram 为 PSRAM 中的 .dram_data（0xa0001000），rodata 为主存
+SECTIONS = {
+    'custom': '.custom_data',
+    'dram':   '.dram_data',
+    'rodata': '.rodata',
+}
+
+# 与 src/dataset.h 保持一致
+DATASET_LZ4 = 1
+
+OPTIONS = {'type', 'section', 'align', 'compress'}
+
+
+class Dataset:
+    def __init__(self, name, path, opts):
+        self.name = name
+        self.path = path
+        self.type = opts.get('type')
+        self.section = opts.get('section', 'custom')
+        self.align = int(opts.get('align', '64'), 0)
+        self.compress = opts.get('compress')
+        self.shape = None
+        self.raw = b''
+        self.stored = b''
+
+
+def fail(where, msg):
+    sys.exit(f'{where}: error: {msg}')
+
+
+def parse_manifest(path):
+    datasets = []
+    base = os.path.dirname(path)
+    with open(path) as f:
+        for lineno, line in enumerate(f, 1):
+            where = f'{path}:{lineno}'
+            fields = line.split('#', 1)[0].split()
+            if not fields:
+                continue
+            if len(fields) < 2:
+                fail(where, 'expected "<name> <file> [options]"')
+            name, file = fields[:2]
+            if not re.fullmatch(r'[A-Za-z_][A-Za-z0-9_]*', name):
+                fail(where, f'"{name}" is not a C identifier')
+            opts = {}
+            for opt in fields[2:]:
+                key, _, value = opt.partition('=')
+                if key not in OPTIONS or not value:
+                    fail(where, f'unknown option "{opt}"')
+                opts[key] = value
+            ds = Dataset(name, os.path.join(base, file), opts)
+            if ds.type is not None and ds.type not in TYPES:
+                fail(where, f'unknown type "{ds.type}", expected one of {", ".join(TYPES)}')
+            if ds.section not in SECTIONS:
+                fail(where, f'unknown section "{ds.section}", expected one of {", ".join(SECTIONS)}')
+            if ds.align <= 0 or ds.align & (ds.align - 1):
+                fail(where, 'align must be a power of two')
+            if ds.compress not in (None, 'lz4'):
+                fail(where, f'unknown compression "{ds.compress}"')
+            if any(d.name == name for d in datasets):
+                fail(where, f'duplicate dataset "{name}"')
+            datasets.append(ds)
+    return datasets
+
+
+def read_csv(ds):
+    """数值以逗号、分号或空白分隔，按行优先展开；第一行不是数值时视为表头跳过"""
+    ctype, fmt, _ = TYPES[ds.type]
+    conv = float if fmt in 'fd' else lambda v: int(v, 0)
+    values = []
+    rows = 0
+    with open(ds.path, newline='') as f:
+        for lineno, row in enumerate(csv.reader(f), 1):
+            cells = [c for cell in row for c in re.split(r'[\s;]+', cell.strip()) if c]
+            if not cells or cells[0].startswith('#'):
+                continue
+            try:
+                values += [conv(c) for c in cells]
+            except ValueError:
+                if rows == 0 and not values:
+                    continue
+                fail(f'{ds.path}:{lineno}', f'cannot parse {ctype} value')
+            rows += 1
+    try:
+        ds.raw = struct.pack(f'<{len(values)}{fmt}', *values)
+    except struct.error as e:
+        fail(ds.path, f'{e} (type={ds.type})')
+    cols = len(values) // rows if rows else 0
+    if rows > 1 and cols > 1 and cols * rows == len(values):
+        ds.shape = (rows, cols)
+
+
+def read_npy(ds):
+    """NumPy .npy（版本 1-3），只支持 C 顺序和上表中的数值类型"""
+    with open(ds.path, 'rb') as f:
+        data = f.read()
+    if data[:6] != b'\x93NUMPY':
+        fail(ds.path, 'not a .npy file')
+    major = data[6]
+    if major == 1:
+        hlen, = struct.unpack_from('<H', data, 8)
+        start = 10
+    else:
+        hlen, = struct.unpack_from('<I', data, 8)
+        start = 12
+    header = ast.literal_eval(data[start:start + hlen].decode('latin1'))
+    descr, shape = header['descr'], tuple(header['shape'])
+    if header.get('fortran_order') and len(shape) > 1:
+        fail(ds.path, 'Fortran-ordered arrays are not supported, save with np.ascontiguousarray()')
+    order, kind = descr[0], descr[1:]
+    if kind not in NPY_TYPES:
+        fail(ds.path, f'unsupported dtype "{descr}"')
+    ntype = NPY_TYPES[kind]
+    if ds.type is not None and ds.type != ntype:
+        fail(ds.path, f'dtype "{descr}" does not match type={ds.type}')
+    ds.type = ntype
+    count = 1
+    for n in shape:
+        count *= n
+    fmt = TYPES[ntype][1]
+    body = data[start + hlen:]
+    if len(body) < count * struct.calcsize(fmt):
+        fail(ds.path, 'file is shorter than its shape')
+    values = struct.unpack(f'{">" if order == ">" else "<"}{count}{fmt}', body[:count * struct.calcsize(fmt)])
+    ds.raw = struct.pack(f'<{count}{fmt}', *values)
+    ds.shape = shape if len(shape) > 1 else None
+
+
+def load(ds):
+    ext = os.path.splitext(ds.path)[1].lower()
+    if not os.path.isfile(ds.path):
+        fail(ds.path, 'file not found')
+    if ext == '.npy':
+        read_npy(ds)
+    elif ext in ('.csv', '.txt'):
+        if ds.type is None:
+            fail(ds.path, 'CSV datasets need type=')
+        read_csv(ds)
+    else:
+        ds.type = ds.type or 'u8'
+        with open(ds.path, 'rb') as f:
+            ds.raw = f.read()
+        if len(ds.raw) % struct.calcsize(TYPES[ds.type][1]):
+            fail(ds.path, f'size is not a multiple of the {ds.type} element size')
+    ds.stored = compress(ds.raw) if ds.compress == 'lz4' else ds.raw
+
+
+def gen_asm(datasets, out_dir):
+    out = ['# Generated by utils/datapack.py, do not edit', '']
+    for ds in datasets:
+        section = SECTIONS[ds.section]
+        out += [f'    .section {section}.ds_{ds.name}, "a"',
+                f'    .balign {ds.align}',
+                f'    .global ds_{ds.name}',
+                f'    .type ds_{ds.name}, @object',
+                f'ds_{ds.name}:',
+                f'    .incbin "{os.path.join(out_dir, ds.name + ".bin")}"',
+                f'    .size ds_{ds.name}, {len(ds.stored)}',
+                '']
+    out += ['    .section .rodata.dataset_names, "aMS", @progbits, 1']
+    for ds in datasets:
+        out.append(f'.Lname_{ds.name}: .asciz "{ds.name}"')
+    # dataset_t: name, data, size, raw_size, elem_size, flags, crc32, 保留
+    out += ['',
+            '    .section .rodata.dataset_table, "a"',
+            '    .balign 8',
+            '    .global dataset_table',
+            'dataset_table:']
+    for ds in datasets:
+        flags = DATASET_LZ4 if ds.compress == 'lz4' else 0
+        elem = struct.calcsize(TYPES[ds.type][1])
+        out += [f'    .dword .Lname_{ds.name}, ds_{ds.name}, {len(ds.stored)}, {len(ds.raw)}',
+                f'    .word {elem}, {flags}, 0x{zlib.crc32(ds.raw):08x}, 0']
+    out += ['    .size dataset_table, . - dataset_table',
+            '',
+            '    .global dataset_count',
+            '    .balign 4',
+            'dataset_count:',
+            f'    .word {len(datasets)}',
+            '']
+    return '\n'.join(out)
+
+
+def gen_header(datasets, manifest):
+    out = ['// Generated by utils/datapack.py from ' + manifest + ', do not edit',
+           '',
+           '#pragma once',
+           '',
+           '#include <stdint.h>',
+           '#include "dataset.h"',
+           '',
+           f'#define DATASET_COUNT {len(datasets)}',
+           '']
+    for i, ds in enumerate(datasets):
+        up = ds.name.upper()
+        ctype = TYPES[ds.type][0]
+        count = len(ds.raw) // struct.calcsize(TYPES[ds.type][1])
+        packed = f', LZ4 {len(ds.stored)} 字节' if ds.compress == 'lz4' else ''
+        out.append(f'// {ds.name}: {ds.path}, {count} x {ctype}, {SECTIONS[ds.section]}{packed}')
+        out.append(f'#define DATASET_{up} {i}')
+        out.append(f'#define DS_{up}_COUNT {count}')
+        out.append(f'#define DS_{up}_SIZE {len(ds.raw)}')
+        for d, n in enumerate(ds.shape or ()):
+            out.append(f'#define DS_{up}_DIM{d} {n}')
+        out.append(f'#define DS_{up}_CRC32 0x{zlib.crc32(ds.raw):08x}u')
+        if ds.compress == 'lz4':
+            # 压缩的数据集须先用 dataset_load() 解压到 DS_<NAME>_COUNT 个元素的缓冲区
+            out.append(f'#define DS_{up}_PACKED_SIZE {len(ds.stored)}')
+            out.append(f'extern const uint8_t ds_{ds.name}[DS_{up}_PACKED_SIZE];')
+        else:
+            out.append(f'extern const {ctype} ds_{ds.name}[DS_{up}_COUNT];')
+        out.append('')
+    return '\n'.join(out)
+
+
+def write(path, content):
+    with open(path, 'wb' if isinstance(content, bytes) else 'w') as f:
+        f.write(content)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Pack the datasets in data/manifest for linking')
+    parser.add_argument('manifest', help='dataset list, e.g. data/manifest')
+    parser.add_argument('--out-dir', required=True, help='where datasets.S, datasets.h and <name>.bin go')
+    args = parser.parse_args()
+
+    datasets = parse_manifest(args.manifest) if os.path.isfile(args.manifest) else []
+    os.makedirs(args.out_dir, exist_ok=True)
+    for ds in datasets:
+        load(ds)
+        write(os.path.join(args.out_dir, f'{ds.name}.bin'), ds.stored)
+        note = f' -> {len(ds.stored)} (lz4)' if ds.compress == 'lz4' else ''
+        print(f'{ds.name}: {ds.path}, {len(ds.raw)} bytes{note}, {SECTIONS[ds.section]}')
+    write(os.path.join(args.out_dir, 'datasets.S'), gen_asm(datasets, args.out_dir))
+    write(os.path.join(args.out_dir, 'datasets.h'), gen_header(datasets, args.manifest))
+
+
+if __name__ == '__main__':
+    main()
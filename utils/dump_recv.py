@@ -0,0 +1,208 @@
+##################################################################################
+# Author:          Mingxuan Li
+# Description:     Receiver for the compressed memory dump stream (src/dump.c)
+##################################################################################
+
+import argparse
+import struct
+import sys
+
+MAGIC = b'\x7fDMP'
+VERSION = 1
+
+FNV_OFFSET = 0x811c9dc5
+FNV_PRIME = 0x01000193
+
+
+class DumpError(Exception):
+    pass
+
+
+def fnv_words(data):
+    # 与 dump_checksum() 一致：按32位半字计算FNV-1a，尾部补零
+    if len(data) % 8:
+        data = data + bytes(8 - len(data) % 8)
+    h = FNV_OFFSET
+    for (half,) in struct.iter_unpack('<I', data):
+        h = ((h ^ half) * FNV_PRIME) & 0xffffffff
+    return h
+
+
+def decode_payload(payload, raw_len):
+    words = []
+    pos = 0
+    while pos < len(payload):
+        token = payload[pos]
+        pos += 1
+        kind = token & 0xC0
+        n = (token & 0x3F) + 1
+        if kind == 0x00:
+            for _ in range(n):
+                words.append(payload[pos:pos + 8])
+                pos += 8
+        elif kind == 0x40:
+            word = payload[pos:pos + 8]
+            pos += 8
+            words.extend([word] * n)
+        elif kind == 0x80:
+            words.extend([bytes(8)] * n)
+        else:
+            dist = payload[pos]
+            pos += 1
+            if dist == 0 or dist > len(words):
+                raise DumpError(f'bad match distance {dist}')
+            for _ in range(n):
+                words.append(words[-dist])
+    data = b''.join(words)
+    if len(data) < raw_len:
+        raise DumpError(f'payload decodes to {len(data)} bytes, expected {raw_len}')
+    return data
+
+
+class Reader:
+    def __init__(self, stream):
+        self.stream = stream
+
+    def read(self, n):
+        buf = b''
+        while len(buf) < n:
+            chunk = self.stream.read(n - len(buf))
+            if not chunk:
+                raise DumpError('unexpected end of stream')
+            buf += chunk
+        return buf
+
+    def sync(self):
+        # 跳过魔数之前的文本输出
+        window = b''
+        while window != MAGIC:
+            c = self.stream.read(1)
+            if not c:
+                raise DumpError('dump header not found')
+            window = (window + c)[-len(MAGIC):]
+
+
+def receive(stream):
+    """返回 (base, length, segments)，segments 为 [(addr, bytes)] 列表（全零段为 None）"""
+    reader = Reader(stream)
+    reader.sync()
+    version, base, length = struct.unpack('<BQQ', reader.read(17))
+    if version != VERSION:
+        raise DumpError(f'unsupported dump version {version}')
+
+    segments = []
+    records = 0
+    while True:
+        tag = reader.read(1)
+        if tag == b'B':
+            addr, raw_len, payload_len = struct.unpack('<QHH', reader.read(12))
+            payload = reader.read(payload_len)
+            (checksum,) = struct.unpack('<I', reader.read(4))
+            data = decode_payload(payload, raw_len)
+            if fnv_words(data) != checksum:
+                raise DumpError(f'checksum mismatch in block at 0x{addr:016x}')
+            segments.append((addr, data[:raw_len]))
+            records += 1
+        elif tag == b'Z':
+            addr, zero_len = struct.unpack('<QI', reader.read(12))
+            segments.append((addr, zero_len))
+            records += 1
+        elif tag == b'E':
+            total, count = struct.unpack('<QI', reader.read(12))
+            if total != length or count != records:
+                raise DumpError(f'trailer mismatch: {count} records / {total} bytes, '
+                                f'received {records} / {length}')
+            return base, length, segments
+        else:
+            raise DumpError(f'unknown record tag {tag!r}')
+
+
+def build_image(base, length, segments):
+    image = bytearray(length)
+    for addr, data in segments:
+        if isinstance(data, int):
+            continue
+        off = addr - base
+        image[off:off + len(data)] = data
+    return image
+
+
+def write_sparse_hex(path, base, image):
+    # 只输出非零的64位字：<地址>: <数据>
+    with open(path, 'w') as f:
+        for off in range(0, len(image), 8):
+            word = bytes(image[off:off + 8]).ljust(8, b'\x00')
+            value = int.from_bytes(word, 'little')
+            if value:
+                f.write(f'{base + off:016x}: {value:016x}\n')
+
+
+def compare(base, image, expected, max_report):
+    errors = 0
+    length = min(len(image), len(expected))
+    for off in range(0, length, 8):
+        got = bytes(image[off:off + 8])
+        exp = expected[off:off + 8]
+        if got != exp:
+            if errors < max_report:
+                print(f'  0x{base + off:016x}: got {got[::-1].hex()}, expected {exp[::-1].hex()}')
+            errors += 1
+    if len(image) != len(expected):
+        print(f'  size differs: dump {len(image)} bytes, expected {len(expected)} bytes')
+        errors += 1
+    return errors
+
+
+def open_input(args):
+    if args.port:
+        try:
+            import serial
+        except ImportError:
+            sys.exit('Error: reading from a serial port requires pyserial (pip install pyserial)')
+        return serial.Serial(args.port, args.baud, timeout=args.timeout)
+    if args.input == '-':
+        return sys.stdin.buffer
+    return open(args.input, 'rb')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Receive a compressed memory dump from dump_region()')
+    parser.add_argument('input', nargs='?', default='-', help='captured UART log (default: stdin)')
+    parser.add_argument('--port', help='read directly from a serial port instead of a file')
+    parser.add_argument('--baud', type=int, default=115200, help='serial baud rate')
+    parser.add_argument('--timeout', type=float, default=10.0, help='serial read timeout in seconds')
+    parser.add_argument('-o', '--output', help='write the raw image to this .bin file')
+    parser.add_argument('--hex', help='write non-zero words to this sparse hex file')
+    parser.add_argument('--expect', help='compare against this raw .bin image')
+    parser.add_argument('--max-report', type=int, default=16, help='maximum mismatches to print')
+
+    args = parser.parse_args()
+
+    stream = open_input(args)
+    try:
+        base, length, segments = receive(stream)
+    except DumpError as e:
+        sys.exit(f'Error: {e}')
+
+    image = build_image(base, length, segments)
+    zero = sum(d for _, d in segments if isinstance(d, int))
+    print(f'Received 0x{base:016x} + {length} bytes in {len(segments)} records ({zero} bytes zero-filled)')
+
+    if args.output:
+        with open(args.output, 'wb') as f:
+            f.write(image)
+    if args.hex:
+        write_sparse_hex(args.hex, base, image)
+
+    if args.expect:
+        with open(args.expect, 'rb') as f:
+            expected = f.read()
+        errors = compare(base, image, expected, args.max_report)
+        if errors:
+            print(f'Mismatch: {errors} words differ from {args.expect}')
+            sys.exit(1)
+        print(f'Match: dump is identical to {args.expect}')
+
+
+if __name__ == '__main__':
+    main()
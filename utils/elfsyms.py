@@ -0,0 +1,104 @@
+##################################################################################
+# Author:          Mingxuan Li
+# Description:     Minimal ELF64 reader (loadable segments and symbol table) and
+#                  address-to-function/line symbolization shared by the utils
+##################################################################################
+
+import bisect
+import shutil
+import struct
+import subprocess
+
+STT_FUNC = 2
+
+
+def _read_sections(data):
+    e_shoff, = struct.unpack_from('<Q', data, 40)
+    e_shentsize, e_shnum = struct.unpack_from('<HH', data, 58)
+    return [struct.unpack_from('<IIQQQQIIQQ', data, e_shoff + i * e_shentsize) for i in range(e_shnum)]
+
+
+def _iter_symbols(data, sections):
+    for sh in sections:
+        if sh[1] != 2:      # SHT_SYMTAB
+            continue
+        strtab = sections[sh[6]]
+        for off in range(sh[4], sh[4] + sh[5], 24):
+            st_name, st_info, _, st_shndx, st_value, st_size = struct.unpack_from('<IBBHQQ', data, off)
+            if st_name == 0:
+                continue
+            end = data.index(b'\0', strtab[4] + st_name)
+            yield data[strtab[4] + st_name:end].decode(), st_info & 0xf, st_shndx, st_value, st_size
+
+
+def read_elf(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    if data[:4] != b'\x7fELF' or data[4] != 2:
+        raise ValueError(f'{path} is not a 64-bit ELF file')
+    return data
+
+
+def load_elf(path):
+    """返回 (入口地址, [(物理地址, 内容)], {符号名: 地址})"""
+    data = read_elf(path)
+    e_entry, e_phoff = struct.unpack_from('<QQ', data, 24)
+    e_phentsize, e_phnum = struct.unpack_from('<HH', data, 54)
+
+    segments = []
+    for i in range(e_phnum):
+        p_type, _, p_offset, _, p_paddr, p_filesz, p_memsz = struct.unpack_from(
+            '<IIQQQQQ', data, e_phoff + i * e_phentsize)
+        if p_type == 1 and p_filesz:
+            segments.append((p_paddr, data[p_offset:p_offset + p_filesz]))
+
+    symbols = {name: value for name, _, _, value, _ in _iter_symbols(data, _read_sections(data))}
+    return e_entry, segments, symbols
+
+
+class Symbolizer:
+    """
+    地址 -> 函数名：用符号表中的函数符号（startup.S 里的标签没有大小，按到下一个符号为止处理）
+    地址 -> 文件:行号：可选，调用 addr2line（需要 -ggdb 编译的 ELF）
+    """
+
+    def __init__(self, path, addr2line=None):
+        data = read_elf(path)
+        funcs = {}
+        labels = {}
+        for name, kind, shndx, value, size in _iter_symbols(data, _read_sections(data)):
+            if shndx == 0 or name.startswith('.L') or name.startswith('$'):
+                continue
+            if kind == STT_FUNC:
+                funcs[value] = (name, size)
+            elif value not in labels and not name.startswith('__'):
+                labels[value] = name
+        for value, name in labels.items():
+            funcs.setdefault(value, (name, 0))
+        self.starts = sorted(funcs)
+        self.funcs = [funcs[a] for a in self.starts]
+        self.path = path
+        self.addr2line = addr2line if addr2line and shutil.which(addr2line) else None
+        self.line_cache = {}
+
+    def function(self, addr):
+        i = bisect.bisect_right(self.starts, addr) - 1
+        if i < 0:
+            return None
+        name, size = self.funcs[i]
+        if size and addr >= self.starts[i] + size:
+            return None
+        return name
+
+    def name(self, addr):
+        return self.function(addr) or f'0x{addr:x}'
+
+    def lines(self, addrs):
+        """批量查询行号，返回 {addr: 'file:line'}；没有 addr2line 时返回空字典"""
+        todo = [a for a in addrs if a not in self.line_cache]
+        if self.addr2line and todo:
+            out = subprocess.run([self.addr2line, '-e', self.path] + [f'0x{a:x}' for a in todo],
+                                 capture_output=True, text=True, check=False).stdout.splitlines()
+            for a, line in zip(todo, out):
+                self.line_cache[a] = None if line.startswith('??') else line.split(' ')[0]
+        return {a: self.line_cache.get(a) for a in addrs if self.line_cache.get(a)}
@@ -0,0 +1,194 @@
+##################################################################################
+# Author:          Mingxuan Li
+# Description:     Rebuild the call tree from @FTRACE function entry/exit records
+#                  (src/ftrace.c, make TRACE=1): call counts, inclusive/self cycles
+##################################################################################
+
+import argparse
+import sys
+from collections import defaultdict
+
+from elfsyms import Symbolizer
+
+EXIT_FLAG = 1
+
+
+def parse_dumps(lines):
+    """返回每次 @FTRACE begin ... end 的 {'lost', 'overhead', 'records': [(fn, is_exit, cycle32)]}"""
+    dumps = []
+    cur = None
+    for line in lines:
+        pos = line.find('@FTRACE ')
+        if pos < 0:
+            continue
+        fields = line[pos:].split()
+        if fields[1] == 'begin':
+            cur = {'count': int(fields[2]), 'lost': int(fields[3]), 'overhead': int(fields[4]), 'records': []}
+        elif cur is None:
+            continue
+        elif fields[1] == 'r':
+            for word in fields[2:]:
+                v = int(word, 16)
+                hi = v >> 32
+                cur['records'].append((hi & ~EXIT_FLAG, hi & EXIT_FLAG, v & 0xffffffff))
+        elif fields[1] == 'end':
+            if len(cur['records']) != cur['count']:
+                print(f'warning: expected {cur["count"]} records, got {len(cur["records"])}', file=sys.stderr)
+            dumps.append(cur)
+            cur = None
+    return dumps
+
+
+def unwrap(records):
+    """mcycle 只记录了低 32 位，按相邻记录单调递增还原成完整周期数"""
+    out = []
+    base = 0
+    prev = None
+    for fn, is_exit, c in records:
+        if prev is not None and c < prev:
+            base += 1 << 32
+        prev = c
+        out.append((fn, is_exit, base + c))
+    return out
+
+
+class Node:
+    __slots__ = ('fn', 'calls', 'incl', 'self', 'children')
+
+    def __init__(self, fn):
+        self.fn = fn
+        self.calls = 0
+        self.incl = 0
+        self.self = 0
+        self.children = {}
+
+    def child(self, fn):
+        if fn not in self.children:
+            self.children[fn] = Node(fn)
+        return self.children[fn]
+
+
+def build(records, overhead):
+    """
+    重放进入/退出记录。环形缓冲区覆盖掉的开头部分会出现没有对应进入的退出，
+    这些函数挂到根下并从第一条记录开始计时；结尾仍未退出的函数在最后一条记录处截止。
+    overhead 为每对 enter/exit 的插桩开销，从每一层的 inclusive 时间中扣除其子调用的份额。
+    """
+    root = Node(None)
+    funcs = defaultdict(lambda: {'calls': 0, 'incl': 0, 'self': 0, 'max': 0, 'depth': 0})
+    # 栈元素：[node, fn, 开始周期, 子调用耗时, 子调用次数]
+    stack = []
+    start = records[0][2] if records else 0
+    end = records[-1][2] if records else 0
+
+    def close(frame, cycle):
+        node, fn, t0, child_time, child_calls = frame
+        incl = max(0, cycle - t0 - child_calls * overhead)
+        self_time = max(0, incl - child_time)
+        node.calls += 1
+        node.incl += incl
+        node.self += self_time
+        f = funcs[fn]
+        f['calls'] += 1
+        f['self'] += self_time
+        f['max'] = max(f['max'], incl)
+        f['depth'] -= 1
+        if f['depth'] == 0:
+            # 递归调用只计最外层的 inclusive，避免重复统计
+            f['incl'] += incl
+        if stack:
+            stack[-1][3] += incl
+            stack[-1][4] += child_calls + 1
+
+    for fn, is_exit, cycle in records:
+        if not is_exit:
+            parent = stack[-1][0] if stack else root
+            funcs[fn]['depth'] += 1
+            stack.append([parent.child(fn), fn, cycle, 0, 0])
+            continue
+        if any(frame[1] == fn for frame in stack):
+            while stack:
+                frame = stack.pop()
+                close(frame, cycle)
+                if frame[1] == fn:
+                    break
+        else:
+            # 进入记录已被覆盖：当作从缓冲区开头就已在执行，其下已完成的调用记为子调用
+            node = root.child(fn)
+            incl = max(0, cycle - start)
+            node.calls += 1
+            node.incl += incl
+            f = funcs[fn]
+            f['calls'] += 1
+            f['incl'] += incl
+            f['max'] = max(f['max'], incl)
+
+    while stack:
+        close(stack.pop(), end)
+    return root, funcs, end - start
+
+
+def print_tree(node, sym, total, min_pct, depth=0, out=sys.stdout):
+    for child in sorted(node.children.values(), key=lambda n: -n.incl):
+        pct = 100.0 * child.incl / total if total else 0
+        if pct < min_pct:
+            continue
+        print(f'{pct:6.2f}% {child.incl:12d} {child.self:12d} {child.calls:8d}  '
+              f'{"  " * depth}{sym.name(child.fn)}', file=out)
+        print_tree(child, sym, total, min_pct, depth + 1, out)
+
+
+def folded(node, sym, prefix, out):
+    for child in node.children.values():
+        path = f'{prefix};{sym.name(child.fn)}' if prefix else sym.name(child.fn)
+        if child.self:
+            out.write(f'{path} {child.self}\n')
+        folded(child, sym, path, out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Rebuild the call tree from @FTRACE records')
+    parser.add_argument('elf', help='bin/$(MAIN).elf built with TRACE=1')
+    parser.add_argument('log', nargs='?', default='-', help='UART log containing @FTRACE lines (default: stdin)')
+    parser.add_argument('--top', type=int, default=30, help='number of functions in the flat profile')
+    parser.add_argument('--min-percent', type=float, default=0.5, help='hide call-tree nodes below this share')
+    parser.add_argument('--no-overhead', action='store_true', help='do not subtract the measured hook overhead')
+    parser.add_argument('--folded', help='write folded stacks weighted by self cycles to this file')
+    args = parser.parse_args()
+
+    if args.log == '-':
+        text = sys.stdin.read()
+    else:
+        with open(args.log, errors='replace') as f:
+            text = f.read()
+    dumps = parse_dumps(text.splitlines())
+    if not dumps:
+        print(f'No complete @FTRACE dump found in {args.log}', file=sys.stderr)
+        sys.exit(1)
+    dump = dumps[-1]
+    records = unwrap(dump['records'])
+    overhead = 0 if args.no_overhead else dump['overhead']
+
+    sym = Symbolizer(args.elf)
+    root, funcs, span = build(records, overhead)
+
+    print(f'{len(records)} records over {span} cycles, {dump["lost"]} older records overwritten, '
+          f'hook overhead {dump["overhead"]} cycles/call' + (' (not subtracted)' if args.no_overhead else ''))
+
+    print(f'\n{"calls":>8} {"inclusive":>12} {"self":>12} {"avg incl":>10} {"max incl":>10}  function')
+    ranked = sorted(funcs.items(), key=lambda kv: -kv[1]['incl'])
+    for fn, f in ranked[:args.top]:
+        avg = f['incl'] // f['calls'] if f['calls'] else 0
+        print(f'{f["calls"]:8d} {f["incl"]:12d} {f["self"]:12d} {avg:10d} {f["max"]:10d}  {sym.name(fn)}')
+
+    print(f'\n{"%":>7} {"inclusive":>12} {"self":>12} {"calls":>8}  call tree')
+    print_tree(root, sym, span, args.min_percent)
+
+    if args.folded:
+        with open(args.folded, 'w') as out:
+            folded(root, sym, '', out)
+        print(f'\nFolded stacks (self cycles) written to {args.folded}')
+
+
+if __name__ == '__main__':
+    main()
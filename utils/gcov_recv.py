@@ -0,0 +1,94 @@
+##################################################################################
+# Author:          Mingxuan Li
+# Description:     Rebuild .gcda files from the @GCOV records printed by
+#                  src/gcov_dump.c (make PGO=gen) for a -fprofile-use build
+##################################################################################
+
+import argparse
+import os
+import sys
+
+
+def fnv1a(data):
+    h = 2166136261
+    for b in data:
+        h = ((h ^ b) * 16777619) & 0xffffffff
+    return h
+
+
+def parse_dumps(lines):
+    """返回每次 @GCOV begin ... end 的 [(gcda 路径, 数据, 是否校验通过)]"""
+    dumps = []
+    cur = None
+    name = None
+    data = bytearray()
+    for line in lines:
+        pos = line.find('@GCOV ')
+        if pos < 0:
+            continue
+        body = line[pos + 6:].rstrip('\r\n')
+        kind, _, rest = body.partition(' ')
+        if kind == 'begin':
+            cur = {'count': int(rest), 'files': []}
+            name = None
+        elif cur is None:
+            continue
+        elif kind == 'file':
+            name = rest
+            data = bytearray()
+        elif kind == 'd' and name is not None:
+            data += bytes.fromhex(rest.strip())
+        elif kind == 'sum' and name is not None:
+            size, digest = rest.split()
+            ok = int(size) == len(data) and int(digest, 16) == fnv1a(data)
+            cur['files'].append((name, bytes(data), ok))
+            name = None
+        elif kind == 'end':
+            dumps.append(cur)
+            cur = None
+        elif kind == 'abort':
+            print('warning: target aborted while dumping counters', file=sys.stderr)
+    return dumps
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Write .gcda files from @GCOV records in a UART log')
+    parser.add_argument('log', nargs='?', default='-', help='UART log containing @GCOV lines (default: stdin)')
+    parser.add_argument('--strip', default='', help='path prefix to remove from the recorded .gcda names')
+    parser.add_argument('--prefix', default='', help='directory to prepend to the (stripped) .gcda names')
+    args = parser.parse_args()
+
+    if args.log == '-':
+        text = sys.stdin.read()
+    else:
+        with open(args.log, errors='replace') as f:
+            text = f.read()
+    dumps = parse_dumps(text.splitlines())
+    if not dumps:
+        print(f'No complete @GCOV dump found in {args.log}', file=sys.stderr)
+        sys.exit(1)
+    dump = dumps[-1]
+    if len(dump['files']) != dump['count']:
+        print(f'warning: expected {dump["count"]} units, got {len(dump["files"])}', file=sys.stderr)
+
+    bad = 0
+    for name, data, ok in dump['files']:
+        if not ok:
+            print(f'error: checksum mismatch for {name}, not written', file=sys.stderr)
+            bad += 1
+            continue
+        path = name
+        if args.strip and path.startswith(args.strip):
+            path = path[len(args.strip):].lstrip('/')
+        if args.prefix:
+            path = os.path.join(args.prefix, path.lstrip('/'))
+        os.makedirs(os.path.dirname(path) or '.', exist_ok=True)
+        with open(path, 'wb') as f:
+            f.write(data)
+        print(f'{len(data):8d} bytes  {path}')
+    if bad:
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
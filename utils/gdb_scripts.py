@@ -8,10 +8,13 @@
 import os
 import argparse
 
-def generate_gdb_script(main_name, output_file):
+def generate_gdb_script(main_name, output_file, load_elf=None):
     """
-    生成GDB调试脚本
+    生成GDB调试脚本；load_elf 为自解压镜像（make COMPRESS=1）时从它加载，
+    符号仍取 bin/<main>.elf，并改用硬件断点（软件断点会被解压覆盖）
     """
+    load_cmd = f"load {load_elf}" if load_elf else "load"
+    break_cmd = "hbreak" if load_elf else "break"
     script_content = f"""# Auto-generated GDB script for {main_name}
 # Author:           Mingxuan Li
 # Acknowledgement:  VSCode GitHub Copilot
@@ -20,10 +23,10 @@ def generate_gdb_script(main_name, output_file):
 file bin/{main_name}.elf
 
 # 加载程序到目标
-load
+{load_cmd}
 
 # 在loop处设置断点
-break loop
+{break_cmd} loop
 
 # 运行程序
 continue
@@ -43,12 +46,13 @@ echo {main_name.upper()} testing completed\\n
 def main():
     parser = argparse.ArgumentParser(description='Generate GDB script for RISC-V debugging')
     parser.add_argument('MAIN', help='Main function file name (without .c extension)')
+    parser.add_argument('--load', help='ELF to load instead of bin/<MAIN>.elf (compressed image)')
 
     args = parser.parse_args()
 
     # 生成GDB脚本
     output_file = os.path.join('scripts', f"{args.MAIN}.gdb")
-    generate_gdb_script(args.MAIN, output_file)
+    generate_gdb_script(args.MAIN, output_file, args.load)
 
 if __name__ == "__main__":
     main()
\ No newline at end of file
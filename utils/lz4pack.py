@@ -0,0 +1,198 @@
+##################################################################################
+# Author:          Mingxuan Li
+# Description:     Pack the loadable segments of an ELF into an LZ4 payload for
+#                  the self-extracting boot stub (src/lz4_stub.S, make COMPRESS=1)
+##################################################################################
+
+import argparse
+import struct
+import sys
+
+from elfsyms import load_elf
+
+RAM_BASE = 0x80000000
+
+# 与 src/lz4_boot.h 保持一致
+LZ4_BOOT_MAGIC = 0x4c5a3442     # "LZ4B"
+HDR_FORMAT = '<8Q'              # magic, entry, info, reloc_end, count, packed, unpacked, 保留
+REC_FORMAT = '<4Q'              # dst, raw_len, comp_len, offset（相对载荷起点）
+
+# LZ4 块格式的限制：最后 5 字节必须是字面量，最后一个匹配须在结尾 12 字节之前开始
+MIN_MATCH = 4
+LAST_LITERALS = 5
+MF_LIMIT = 12
+MAX_OFFSET = 65535
+
+
+def write_length(out, value):
+    while value >= 255:
+        out.append(255)
+        value -= 255
+    out.append(value)
+
+
+def emit_sequence(out, literals, offset, match_len):
+    lit_len = len(literals)
+    ml = match_len - MIN_MATCH
+    out.append((min(lit_len, 15) << 4) | min(ml, 15))
+    if lit_len >= 15:
+        write_length(out, lit_len - 15)
+    out += literals
+    out += offset.to_bytes(2, 'little')
+    if ml >= 15:
+        write_length(out, ml - 15)
+
+
+def compress(src):
+    """贪心 LZ4 块压缩（哈希表记录每个 4 字节序列最后出现的位置）"""
+    out = bytearray()
+    n = len(src)
+    table = {}
+    anchor = 0
+    i = 0
+    while i < n - MF_LIMIT:
+        key = src[i:i + 4]
+        cand = table.get(key)
+        table[key] = i
+        if cand is None or i - cand > MAX_OFFSET:
+            i += 1
+            continue
+        limit = n - LAST_LITERALS
+        m = MIN_MATCH
+        while i + m < limit and src[cand + m] == src[i + m]:
+            m += 1
+        while i > anchor and cand > 0 and src[i - 1] == src[cand - 1]:
+            i -= 1
+            cand -= 1
+            m += 1
+        emit_sequence(out, src[anchor:i], i - cand, m)
+        # 匹配内部隔几个位置登记一次，兼顾压缩率和速度
+        for j in range(i + 1, i + m - 3, 7):
+            table[src[j:j + 4]] = j
+        i += m
+        anchor = i
+    literals = src[anchor:]
+    out.append(min(len(literals), 15) << 4)
+    if len(literals) >= 15:
+        write_length(out, len(literals) - 15)
+    out += literals
+    return bytes(out)
+
+
+def decompress(data):
+    """
+    返回 (解压结果, 原地解压所需的最小间距)：输入末尾放在输出起点 + 输出长度 + 间距之后时，
+    按 src/lz4_stub.S 的顺序逐字节解压，写指针永远不会越过尚未读取的输入
+    """
+    out = bytearray()
+    ip = 0
+    gap = 0
+    while ip < len(data):
+        gap = max(gap, len(out) - ip)
+        token = data[ip]
+        ip += 1
+        lit_len = token >> 4
+        if lit_len == 15:
+            while True:
+                b = data[ip]
+                ip += 1
+                lit_len += b
+                if b != 255:
+                    break
+        out += data[ip:ip + lit_len]
+        ip += lit_len
+        if ip >= len(data):
+            break
+        offset = data[ip] | (data[ip + 1] << 8)
+        ip += 2
+        match_len = token & 15
+        if match_len == 15:
+            while True:
+                b = data[ip]
+                ip += 1
+                match_len += b
+                if b != 255:
+                    break
+        match_len += MIN_MATCH
+        if offset == 0 or offset > len(out):
+            raise ValueError('bad match offset')
+        for _ in range(match_len):
+            out.append(out[-offset])
+        gap = max(gap, len(out) - ip)
+    # 间距相对输入末尾：输入起点须不低于 输出起点 + gap
+    return bytes(out), gap - len(out) + len(data) if out else 0
+
+
+def load_records(path, ram_base, ram_size):
+    """
+    RAM 中的段合并为一条记录，段间空隙和 .bss（到 linker.ld 的 __bss_end）补零，
+    这样解压后 .bss 与直接加载 ELF 时一样为 0；其余段（如 SPM 中的 .custom_data）各一条
+    """
+    entry, segments, symbols = load_elf(path)
+    in_ram = [ram_base <= a < ram_base + ram_size for a, _ in segments]
+    ram = [seg for seg, r in zip(segments, in_ram) if r]
+    records = [seg for seg, r in zip(segments, in_ram) if not r]
+    if ram:
+        start = min(a for a, _ in ram)
+        end = max(a + len(d) for a, d in ram)
+        bss_end = symbols.get('__bss_end', 0)
+        if ram_base <= bss_end < ram_base + ram_size:
+            end = max(end, bss_end)
+        image = bytearray(end - start)
+        for a, d in ram:
+            image[a - start:a - start + len(d)] = d
+        records.append((start, bytes(image)))
+    return entry, records, symbols
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Pack an ELF into an LZ4 payload for src/lz4_stub.S')
+    parser.add_argument('elf', help='program to pack, e.g. bin/main.elf')
+    parser.add_argument('-o', '--output', required=True, help='payload file included by the stub')
+    parser.add_argument('--ram-base', type=lambda v: int(v, 0), default=RAM_BASE,
+                        help='segments from here up are decompressed in place (stub link address)')
+    parser.add_argument('--ram-size', type=lambda v: int(v, 0), default=0x10000000,
+                        help='size of the RAM window decompressed in place')
+    parser.add_argument('--info-symbol', default='lz4_boot_info',
+                        help='where the stub stores its statistics (src/lz4_boot.c)')
+    args = parser.parse_args()
+
+    entry, records, symbols = load_records(args.elf, args.ram_base, args.ram_size)
+    if not records:
+        sys.exit(f'error: {args.elf} has no loadable segments')
+
+    header_size = struct.calcsize(HDR_FORMAT) + struct.calcsize(REC_FORMAT) * len(records)
+    table = bytearray()
+    blob = bytearray()
+    reloc_end = 0
+    unpacked = 0
+    for dst, raw in records:
+        comp = compress(raw)
+        check, gap = decompress(comp)
+        if check != raw:
+            sys.exit(f'error: LZ4 round trip failed for segment at 0x{dst:x}')
+        table += struct.pack(REC_FORMAT, dst, len(raw), len(comp), header_size + len(blob))
+        blob += comp
+        unpacked += len(raw)
+        if args.ram_base <= dst < args.ram_base + args.ram_size:
+            # 最后一条（RAM）记录在载荷末尾：载荷结束地址须留出原地解压的间距，
+            # 另加 16 字节给载荷末尾的对齐填充
+            reloc_end = (dst + len(raw) + gap + 16 + 15) & ~15
+
+    info = symbols.get(args.info_symbol, 0)
+    if not info:
+        print(f'warning: {args.info_symbol} not found, boot statistics will not be recorded', file=sys.stderr)
+    header = struct.pack(HDR_FORMAT, LZ4_BOOT_MAGIC, entry, info, reloc_end, len(records), len(blob), unpacked, 0)
+    payload = header + table + blob
+    # 补齐到 16 字节，stub 中载荷之后的代码不需要再对齐
+    payload += bytes(-len(payload) % 16)
+    with open(args.output, 'wb') as f:
+        f.write(payload)
+
+    ratio = len(payload) * 100 / unpacked if unpacked else 0
+    print(f'{args.elf}: {unpacked} -> {len(payload)} bytes ({ratio:.1f}%), {len(records)} segment(s), '
+          f'payload moved to end at 0x{reloc_end:x}')
+
+
+if __name__ == '__main__':
+    main()
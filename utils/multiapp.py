@@ -0,0 +1,104 @@
+##################################################################################
+# Author:          Mingxuan Li
+# Description:     Generate the linker script and app table for a multi-application
+#                  image (make multi): per-app .data/.bss sections and shadow copies
+##################################################################################
+
+import argparse
+import os
+import re
+import sys
+
+DATA_INPUTS = '.data .data.* .sdata .sdata.*'
+BSS_INPUTS = '.sbss .sbss.* .bss .bss.* COMMON'
+
+
+def app_sections(app, obj):
+    """程序的 .data/.bss 按输入文件名单独成段，必须放在通用的 *(.data) 之前才能先匹配"""
+    return f'''    .app.{app}.data : {{
+        . = ALIGN(16);
+        __app_{app}_data_start = .;
+        {obj}({DATA_INPUTS})
+        . = ALIGN(16);
+        __app_{app}_data_end = .;
+    }}
+
+    .app.{app}.bss : {{
+        __app_{app}_bss_start = .;
+        {obj}({BSS_INPUTS})
+        . = ALIGN(16);
+        __app_{app}_bss_end = .;
+    }}
+
+'''
+
+
+def shadow_sections(apps):
+    """.data 初始值的备份，NOLOAD 不占镜像空间"""
+    body = ''.join(f'''        __app_{app}_shadow = .;
+        . += __app_{app}_data_end - __app_{app}_data_start;
+''' for app in apps)
+    return f'''    .app.shadow (NOLOAD) : {{
+        . = ALIGN(16);
+{body}    }}
+
+'''
+
+
+def gen_linker(template, apps, objs):
+    text = template
+    data_pos = text.find('    .data :')
+    if data_pos < 0:
+        raise ValueError('template has no .data output section')
+    text = text[:data_pos] + ''.join(app_sections(a, o) for a, o in zip(apps, objs)) + text[data_pos:]
+    # 备份区放在 .bss 之后、SPM 段之前
+    spm_pos = text.find('    . = 0x30000000;')
+    if spm_pos < 0:
+        raise ValueError('template has no SPM location counter assignment')
+    return text[:spm_pos] + shadow_sections(apps) + text[spm_pos:]
+
+
+def gen_table(apps):
+    lines = ['// Auto-generated by utils/multiapp.py, do not edit', '', '#include "apps.h"', '']
+    for app in apps:
+        lines.append(f'extern int __app_{app}_main(void);')
+        lines.append(f'extern char __app_{app}_data_start[], __app_{app}_data_end[], '
+                     f'__app_{app}_bss_start[], __app_{app}_bss_end[], __app_{app}_shadow[];')
+    lines += ['', 'const app_t app_table[] = {']
+    for app in apps:
+        lines.append(f'    {{"{app}", __app_{app}_main, __app_{app}_data_start, __app_{app}_data_end, '
+                     f'__app_{app}_bss_start, __app_{app}_bss_end, __app_{app}_shadow}},')
+    lines += ['};', '', f'const int app_count = {len(apps)};', '']
+    return '\n'.join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Generate linker script and app table for make multi')
+    parser.add_argument('apps', nargs='+', help='MAIN programs to include, e.g. main uart_func dram_func')
+    parser.add_argument('--template', default='linker.ld', help='single-program linker script to extend')
+    parser.add_argument('--obj-dir', default='build/multi', help='directory holding <app>.o')
+    parser.add_argument('--out-dir', default='build/multi', help='where to write linker.ld and apps.c')
+    args = parser.parse_args()
+
+    apps = []
+    for app in args.apps:
+        if not re.fullmatch(r'[A-Za-z_][A-Za-z0-9_]*', app):
+            sys.exit(f'error: app name "{app}" is not a C identifier')
+        if app == 'menu':
+            sys.exit('error: menu is the resident program and cannot be an app')
+        if app not in apps:
+            apps.append(app)
+    objs = [os.path.join(args.obj_dir, f'{app}.o') for app in apps]
+
+    with open(args.template) as f:
+        template = f.read()
+    os.makedirs(args.out_dir, exist_ok=True)
+    with open(os.path.join(args.out_dir, 'linker.ld'), 'w') as f:
+        f.write(gen_linker(template, apps, objs))
+    with open(os.path.join(args.out_dir, 'apps.c'), 'w') as f:
+        f.write(gen_table(apps))
+    print(f'Multi-app image: {", ".join(apps)}')
+
+
+if __name__ == '__main__':
+    main()
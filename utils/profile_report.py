@@ -0,0 +1,129 @@
+##################################################################################
+# Author:          Mingxuan Li
+# Description:     Symbolize @PROF sampling-profiler dumps (src/profiler.c) against
+#                  bin/$(MAIN).elf: ranked function/line report and folded stacks
+##################################################################################
+
+import argparse
+import sys
+from collections import Counter
+
+from elfsyms import Symbolizer
+
+
+def parse_dumps(lines):
+    """返回每次 @PROF begin ... end 的 {'period', 'samples', 'dropped', 'pcs', 'stacks'}"""
+    dumps = []
+    cur = None
+    for line in lines:
+        pos = line.find('@PROF ')
+        if pos < 0:
+            continue
+        fields = line[pos:].split()
+        kind = fields[1]
+        if kind == 'begin':
+            cur = {'period': int(fields[2]), 'samples': int(fields[3]), 'dropped': int(fields[4]),
+                   'pcs': Counter(), 'stacks': Counter(), 'stack_dropped': 0}
+        elif cur is None:
+            continue
+        elif kind == 'pc':
+            cur['pcs'][int(fields[2], 16)] += int(fields[3])
+        elif kind == 'stack':
+            cur['stacks'][tuple(int(f, 16) for f in fields[3:])] += int(fields[2])
+        elif kind == 'stack_dropped':
+            cur['stack_dropped'] = int(fields[2])
+        elif kind == 'end':
+            dumps.append(cur)
+            cur = None
+    return dumps
+
+
+def merge(dumps):
+    total = {'period': dumps[-1]['period'], 'samples': 0, 'dropped': 0,
+             'pcs': Counter(), 'stacks': Counter(), 'stack_dropped': 0}
+    for d in dumps:
+        for key in ('samples', 'dropped', 'stack_dropped'):
+            total[key] += d[key]
+        total['pcs'].update(d['pcs'])
+        total['stacks'].update(d['stacks'])
+    return total
+
+
+def folded_stacks(prof, sym):
+    """flamegraph.pl / speedscope 使用的 folded 格式：外层;...;叶子 次数"""
+    folded = Counter()
+    if prof['stacks']:
+        for pcs, count in prof['stacks'].items():
+            # 返回地址指向 call 的下一条指令，减 1 后落在调用者内
+            names = [sym.name(pcs[0])] + [sym.name(ra - 1) for ra in pcs[1:]]
+            folded[';'.join(reversed(names))] += count
+    else:
+        for pc, count in prof['pcs'].items():
+            folded[sym.name(pc)] += count
+    return folded
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Turn @PROF profiler dumps into a ranked report and folded stacks')
+    parser.add_argument('elf', help='bin/$(MAIN).elf the dump was taken from')
+    parser.add_argument('log', nargs='?', default='-', help='UART log containing @PROF lines (default: stdin)')
+    parser.add_argument('--addr2line', help='addr2line binary for file:line attribution')
+    parser.add_argument('--folded', help='write folded stacks (for flamegraph.pl) to this file')
+    parser.add_argument('--top', type=int, default=20, help='number of functions / lines to list')
+    parser.add_argument('--all', action='store_true', help='merge every dump in the log instead of using the last one')
+    args = parser.parse_args()
+
+    if args.log == '-':
+        text = sys.stdin.read()
+    else:
+        with open(args.log, errors='replace') as f:
+            text = f.read()
+    dumps = parse_dumps(text.splitlines())
+    if not dumps:
+        print(f'No complete @PROF dump found in {args.log}', file=sys.stderr)
+        sys.exit(1)
+    prof = merge(dumps) if args.all else dumps[-1]
+
+    sym = Symbolizer(args.elf, args.addr2line)
+    recorded = sum(prof['pcs'].values())
+    if recorded == 0:
+        print('Profile is empty (was the tick running?)', file=sys.stderr)
+        sys.exit(1)
+
+    print(f'Samples: {prof["samples"]} every {prof["period"]} us '
+          f'(~{prof["samples"] * prof["period"] / 1000:.1f} ms), '
+          f'{prof["dropped"]} dropped (histogram full)')
+
+    funcs = Counter()
+    for pc, count in prof['pcs'].items():
+        funcs[sym.name(pc)] += count
+
+    print(f'\n{"%":>7} {"samples":>8}  function')
+    for name, count in funcs.most_common(args.top):
+        print(f'{100.0 * count / recorded:6.2f}% {count:8d}  {name}')
+
+    lines = sym.lines(list(prof['pcs']))
+    if lines:
+        per_line = Counter()
+        owner = {}
+        for pc, count in prof['pcs'].items():
+            loc = lines.get(pc, f'0x{pc:x}')
+            per_line[loc] += count
+            owner[loc] = sym.name(pc)
+        print(f'\n{"%":>7} {"samples":>8}  line')
+        for loc, count in per_line.most_common(args.top):
+            print(f'{100.0 * count / recorded:6.2f}% {count:8d}  {loc}  ({owner[loc]})')
+
+    if args.folded:
+        folded = folded_stacks(prof, sym)
+        with open(args.folded, 'w') as f:
+            for stack, count in sorted(folded.items()):
+                f.write(f'{stack} {count}\n')
+        kind = 'call stacks' if prof['stacks'] else 'leaf functions only (build with PROFILE=1 for stacks)'
+        print(f'\nFolded stacks ({kind}) written to {args.folded}')
+        if prof['stack_dropped']:
+            print(f'  {prof["stack_dropped"]} stack samples dropped (stack table full)')
+
+
+if __name__ == '__main__':
+    main()
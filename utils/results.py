@@ -0,0 +1,172 @@
+##################################################################################
+# Author:          Mingxuan Li
+# Description:     Collect @RESULT records from a UART log, store runs and gate
+#                  cycle-count regressions against a baseline file
+##################################################################################
+
+import argparse
+import json
+import os
+import sys
+import time
+
+METRICS = ('cycles', 'instret', 'bytes', 'errors')
+
+# 默认容差：周期数允许 2% 波动，指令数 0.5%；bytes/errors 不比较大小，errors 非 0 直接失败
+DEFAULT_TOLERANCE = {'cycles': '2%', 'instret': '0.5%'}
+
+
+def parse_results(lines):
+    """返回 {program/test: record}，同名测试以最后一次为准"""
+    results = {}
+    for n, line in enumerate(lines, 1):
+        pos = line.find('@RESULT ')
+        if pos < 0:
+            continue
+        try:
+            rec = json.loads(line[pos + 8:].strip())
+        except json.JSONDecodeError as e:
+            print(f'warning: line {n}: bad @RESULT record ({e})', file=sys.stderr)
+            continue
+        key = f'{rec.get("program", "unknown")}/{rec.get("test", "unknown")}'
+        results[key] = {m: int(rec.get(m, 0)) for m in METRICS}
+    return results
+
+
+def parse_tolerance(text):
+    """'2%' -> (0.02, 0)；'100' -> (0, 100)"""
+    text = str(text).strip()
+    if text.endswith('%'):
+        return float(text[:-1]) / 100, 0
+    return 0.0, int(text, 0)
+
+
+def tolerance_for(tolerances, key, metric):
+    """查找顺序：program/test:metric、test:metric、metric"""
+    test = key.split('/', 1)[1]
+    for name in (f'{key}:{metric}', f'{test}:{metric}', metric):
+        if name in tolerances:
+            return parse_tolerance(tolerances[name])
+    return None
+
+
+def compare(results, baseline, tolerances):
+    """返回 (回退列表, 报告行)"""
+    failures = []
+    rows = []
+    for key in sorted(set(baseline) | set(results)):
+        cur = results.get(key)
+        base = baseline.get(key)
+        if cur is None:
+            failures.append(f'{key}: missing from this run')
+            continue
+        if cur['errors']:
+            failures.append(f'{key}: {cur["errors"]} errors')
+        if base is None:
+            rows.append((key, 'cycles', None, cur['cycles'], 'new'))
+            continue
+        for metric in ('cycles', 'instret'):
+            tol = tolerance_for(tolerances, key, metric)
+            if tol is None or (base[metric] == 0 and cur[metric] == 0):
+                continue
+            rel, absolute = tol
+            limit = base[metric] + max(base[metric] * rel, absolute)
+            if cur[metric] > limit:
+                status = 'REGRESSION'
+                failures.append(f'{key}: {metric} {base[metric]} -> {cur[metric]} '
+                                f'({delta(base[metric], cur[metric])}, limit {int(limit)})')
+            elif cur[metric] < base[metric] - max(base[metric] * rel, absolute):
+                status = 'improved'
+            else:
+                status = 'ok'
+            rows.append((key, metric, base[metric], cur[metric], status))
+    return failures, rows
+
+
+def delta(base, cur):
+    if base == 0:
+        return 'n/a'
+    return f'{(cur - base) * 100 / base:+.2f}%'
+
+
+def load_baseline(path):
+    with open(path) as f:
+        data = json.load(f)
+    return data.get('results', {}), data.get('tolerance', {})
+
+
+def save_baseline(path, results, tolerances):
+    os.makedirs(os.path.dirname(path) or '.', exist_ok=True)
+    with open(path, 'w') as f:
+        json.dump({'tolerance': tolerances, 'results': results}, f, indent=2, sort_keys=True)
+        f.write('\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare @RESULT records in a UART log against a baseline')
+    parser.add_argument('log', help='UART log containing @RESULT lines')
+    parser.add_argument('--baseline', help='baseline JSON file to compare against')
+    parser.add_argument('--update', action='store_true', help='write this run as the new baseline')
+    parser.add_argument('--force', action='store_true', help='allow --update even when records report errors')
+    parser.add_argument('--store', help='append this run to a JSON-lines history file')
+    parser.add_argument('--label', default='', help='label recorded with --store, e.g. a git revision')
+    parser.add_argument('--tol', action='append', default=[], metavar='[TEST:]METRIC=VALUE[%]',
+                        help='tolerance override, e.g. cycles=5%% or crc32:cycles=200')
+    args = parser.parse_args()
+
+    with open(args.log, errors='replace') as f:
+        results = parse_results(f.read().splitlines())
+    if not results:
+        print(f'No @RESULT records found in {args.log}', file=sys.stderr)
+        sys.exit(1)
+
+    if args.store:
+        with open(args.store, 'a') as f:
+            f.write(json.dumps({'time': int(time.time()), 'label': args.label, 'log': args.log,
+                                'results': results}, sort_keys=True) + '\n')
+
+    baseline = {}
+    tolerances = dict(DEFAULT_TOLERANCE)
+    if args.baseline and os.path.exists(args.baseline):
+        baseline, saved = load_baseline(args.baseline)
+        tolerances.update(saved)
+    for item in args.tol:
+        name, sep, value = item.partition('=')
+        if not sep:
+            sys.exit(f'error: bad --tol "{item}", expected METRIC=VALUE')
+        tolerances[name.strip()] = value.strip()
+
+    failures, rows = compare(results, baseline, tolerances)
+    width = max(len(r[0]) for r in rows) if rows else 10
+    for key, metric, base, cur, status in rows:
+        if base is None:
+            print(f'{key:<{width}}  {metric:<7}  {"-":>12}  {cur:>12}  {"":>8}  {status}')
+        else:
+            print(f'{key:<{width}}  {metric:<7}  {base:>12}  {cur:>12}  {delta(base, cur):>8}  {status}')
+
+    if args.update:
+        if not args.baseline:
+            sys.exit('error: --update needs --baseline')
+        # 自检失败的运行不能成为基准，否则之后的比较都以错误结果为参照
+        failed = [key for key, rec in results.items() if rec['errors']]
+        if failed and not args.force:
+            for key in failed:
+                print(f'  {key}: {results[key]["errors"]} errors', file=sys.stderr)
+            sys.exit(f'error: {len(failed)} result(s) report errors, baseline not updated (use --force to override)')
+        save_baseline(args.baseline, results, {k: v for k, v in tolerances.items() if k not in DEFAULT_TOLERANCE
+                                               or v != DEFAULT_TOLERANCE[k]})
+        print(f'Baseline written to {args.baseline} ({len(results)} results)')
+        return
+    if args.baseline and not baseline:
+        print(f'No baseline at {args.baseline}; run with --update to create it')
+
+    if failures:
+        print(f'{len(failures)} failure(s):')
+        for msg in failures:
+            print(f'  {msg}')
+        sys.exit(1)
+    print(f'{len(results)} results, no regressions')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,1216 @@
+##################################################################################
+# Author:          Mingxuan Li
+# Description:     Minimal RV64IMA_Zicsr virtual platform for running bin/$(MAIN).elf
+#                  without an FPGA: 16550 UART (4-byte stride), CLINT, RAM/SPM/PSRAM,
+#                  semihosting console, scripted UART input, per-test cycle statistics
+#                  optional extra harts (--harts) and Zba/Zbb/Zbc/Zbs (--ext)
+##################################################################################
+
+import argparse
+import codecs
+import json
+import re
+import sys
+import time
+from collections import deque
+
+from elfsyms import load_elf
+
+MASK64 = (1 << 64) - 1
+SIGN64 = 1 << 63
+
+RAM_BASE = 0x80000000
+SPM_BASE = 0x30000000
+PSRAM_BASE = 0xa0000000
+DRAMCTL_BASE = 0xe0000000
+UART_BASE = 0x10000000
+CLINT_BASE = 0x02000000
+
+# 两次 LSR 读取间隔不超过该指令数视为忙等
+POLL_GAP_INSNS = 64
+
+SEMIHOST_PRE = 0x01f01013       # slli x0, x0, 0x1f
+SEMIHOST_POST = 0x40705013      # srai x0, x0, 7
+SYS_WRITEC = 0x03
+SYS_WRITE0 = 0x04
+SYS_WRITE = 0x05
+SYS_READC = 0x07
+
+CSR_MSTATUS = 0x300
+CSR_MISA = 0x301
+CSR_MIE = 0x304
+CSR_MTVEC = 0x305
+CSR_MEPC = 0x341
+CSR_MCAUSE = 0x342
+CSR_MTVAL = 0x343
+CSR_MIP = 0x344
+CSR_MCYCLE = 0xB00
+CSR_MINSTRET = 0xB02
+CSR_CYCLE = 0xC00
+CSR_TIME = 0xC01
+CSR_INSTRET = 0xC02
+CSR_MHARTID = 0xF14
+
+MSTATUS_MIE = 1 << 3
+MSTATUS_MPIE = 1 << 7
+MSTATUS_MPP = 3 << 11
+
+MIP_MSIP = 1 << 3
+MIP_MTIP = 1 << 7
+
+CAUSE_ILLEGAL = 2
+CAUSE_BREAKPOINT = 3
+CAUSE_LOAD_MISALIGNED = 4
+CAUSE_LOAD_FAULT = 5
+CAUSE_STORE_MISALIGNED = 6
+CAUSE_STORE_FAULT = 7
+CAUSE_ECALL_M = 11
+
+
+def sx(value, bits):
+    value &= (1 << bits) - 1
+    return value - (1 << bits) if value >> (bits - 1) else value
+
+
+def s64(value):
+    return value - (1 << 64) if value & SIGN64 else value
+
+
+def sx32(value):
+    value &= 0xffffffff
+    return (value - (1 << 32) if value & 0x80000000 else value) & MASK64
+
+
+class Trap(Exception):
+    def __init__(self, cause, tval=0):
+        super().__init__(cause, tval)
+        self.cause = cause
+        self.tval = tval
+
+
+class Halt(Exception):
+    pass
+
+
+##################################################################################
+# 外设模型
+##################################################################################
+
+class Uart16550:
+    """16550 UART，寄存器间隔4字节；可按波特率模拟发送/接收时间"""
+
+    def __init__(self, machine, model_baud, echo, fast_poll, rx_fifo=0):
+        self.m = machine
+        self.rx_fifo = rx_fifo      # 接收 FIFO 深度，0 为不限（不会溢出）
+        self.overrun = False        # LSR.OE，读 LSR 后清除
+        self.overruns = 0
+        self.model_baud = model_baud
+        self.fast_poll = fast_poll
+        self.echo = echo
+        self.regs = {4: 0, 12: 0, 16: 0, 28: 0}
+        self.dll = 0
+        self.dlm = 0
+        self.tx_done = 0            # 最后一个字节发送完成的周期
+        self.rx = deque()           # (到达周期, 字节)
+        self.output = bytearray()
+        self.bytes_in = 0
+        self.line = bytearray()
+        self.on_line = None
+        self.last_poll = None       # 上一次读到 THRE 未就绪时的 instret
+
+    def char_cycles(self):
+        divisor = (self.dlm << 8) | self.dll
+        if not self.model_baud or divisor == 0:
+            return 0
+        return 10 * 16 * divisor    # 1起始位 + 8数据位 + 1停止位
+
+    def feed(self, data):
+        t = max(self.m.cycle, self.rx[-1][0] if self.rx else 0)
+        step = self.char_cycles()
+        for b in data:
+            t += step
+            self.rx.append((t, b))
+
+    def rx_ready(self):
+        return bool(self.rx) and self.rx[0][0] <= self.m.cycle
+
+    def check_overrun(self):
+        """FIFO 已满时后到的字节丢失并置 OE，与 16550 一样保留 FIFO 中已有的内容"""
+        if not self.rx_fifo:
+            return
+        now = self.m.cycle
+        arrived = 0
+        for t, _ in self.rx:
+            if t > now:
+                break
+            arrived += 1
+        while arrived > self.rx_fifo:
+            del self.rx[self.rx_fifo]
+            arrived -= 1
+            self.overruns += 1
+            self.overrun = True
+
+    def read(self, off, size):
+        dlab = self.regs[12] & 0x80
+        if off == 0:
+            if dlab:
+                return self.dll
+            self.check_overrun()
+            if self.rx_ready():
+                self.bytes_in += 1
+                return self.rx.popleft()[1]
+            return 0
+        if off == 4:
+            return self.dlm if dlab else self.regs[4]
+        if off == 8:
+            return 0xc1     # FIFO enabled, no interrupt pending
+        if off == 20:
+            now = self.m.cycle
+            thre_at = self.tx_done - self.char_cycles()
+            # 只有紧接着的连续轮询才算忙等；两次轮询之间执行了较多指令（如调度器切到
+            # 其他任务）时不快进，让这段时间与发送重叠
+            polling = self.last_poll is not None and self.m.instret - self.last_poll <= POLL_GAP_INSNS
+            self.last_poll = self.m.instret if thre_at > now else None
+            if self.fast_poll and polling and thre_at > now and not self.rx_ready():
+                # 忙等 THRE 时直接快进时间：mcycle 照常累计，但不再逐条模拟轮询指令
+                target = thre_at
+                if self.rx and self.rx[0][0] > now:
+                    target = min(target, self.rx[0][0])
+                timer = self.m.timer_check_cycle()
+                if timer is not None and now < timer:
+                    target = min(target, timer)
+                self.m.cycle = now = target
+            self.check_overrun()
+            lsr = 0
+            if self.overrun:
+                lsr |= 0x02
+                self.overrun = False
+            if self.rx_ready():
+                lsr |= 0x01
+            if thre_at <= now:
+                lsr |= 0x20
+            if self.tx_done <= now:
+                lsr |= 0x40
+            return lsr
+        if off == 24:
+            return 0xb0     # CTS, DSR, DCD
+        return self.regs.get(off, 0)
+
+    def write(self, off, size, value):
+        value &= 0xff
+        dlab = self.regs[12] & 0x80
+        if off == 0:
+            if dlab:
+                self.dll = value
+            else:
+                self.transmit(value)
+        elif off == 4:
+            if dlab:
+                self.dlm = value
+            else:
+                self.regs[4] = value
+        elif off in self.regs:
+            self.regs[off] = value
+
+    def transmit(self, value):
+        self.tx_done = max(self.tx_done, self.m.cycle) + self.char_cycles()
+        self.emit(value)
+
+    def emit(self, value):
+        """记录一个输出字节；半主机输出也走这里，不计波特率时间"""
+        self.output.append(value)
+        if self.echo:
+            sys.stdout.buffer.write(bytes([value]))
+            if value == 0x0a:
+                sys.stdout.flush()
+        if value == 0x0a:
+            if self.on_line:
+                self.on_line(bytes(self.line))
+            self.line.clear()
+        else:
+            self.line.append(value)
+
+
+class Clint:
+    """msip 与 mtimecmp 每个 hart 一份（偏移 4*hartid / 0x4000+8*hartid），mtime 取当前 hart 的周期"""
+
+    def __init__(self, machine, mtime_freq):
+        self.m = machine
+        self.mtime_freq = mtime_freq
+        self.harts = [machine]
+        self.msip = [0]
+        self.mtimecmp = [MASK64]
+
+    def add_hart(self, hart):
+        self.harts.append(hart)
+        self.msip.append(0)
+        self.mtimecmp.append(MASK64)
+
+    def mtime(self):
+        return self.m.cycle * self.mtime_freq // self.m.cpu_freq
+
+    def cycle_for_mtime(self, mtime):
+        return -(-mtime * self.m.cpu_freq // self.mtime_freq)
+
+    def read(self, off, size):
+        n = len(self.harts)
+        if off < 4 * n:
+            return self.msip[off // 4]
+        if 0x4000 <= off < 0x4000 + 8 * n:
+            h = (off - 0x4000) // 8
+            return (self.mtimecmp[h] >> ((off - 0x4000 - 8 * h) * 8)) & ((1 << (size * 8)) - 1)
+        if 0xbff8 <= off < 0xc000:
+            return (self.mtime() >> ((off - 0xbff8) * 8)) & ((1 << (size * 8)) - 1)
+        return 0
+
+    def write(self, off, size, value):
+        n = len(self.harts)
+        if off < 4 * n:
+            self.msip[off // 4] = value & 1
+        elif 0x4000 <= off < 0x4000 + 8 * n:
+            h = (off - 0x4000) // 8
+            shift = (off - 0x4000 - 8 * h) * 8
+            mask = ((1 << (size * 8)) - 1) << shift
+            self.mtimecmp[h] = (self.mtimecmp[h] & ~mask) | ((value << shift) & mask)
+        for hart in self.harts:
+            hart.schedule_irq_check()
+
+
+class Scratch:
+    """可读写的寄存器组（如 DRAM 控制器配置寄存器）"""
+
+    def __init__(self, size):
+        self.mem = bytearray(size)
+
+    def read(self, off, size):
+        return int.from_bytes(self.mem[off:off + size], 'little')
+
+    def write(self, off, size, value):
+        self.mem[off:off + size] = value.to_bytes(size, 'little')
+
+
+##################################################################################
+# 指令译码
+##################################################################################
+
+def div_trunc(a, b):
+    q = abs(a) // abs(b)
+    return q if (a < 0) == (b < 0) else -q
+
+
+def alu_div(a, b):
+    a, b = s64(a), s64(b)
+    if b == 0:
+        return MASK64
+    if a == -(1 << 63) and b == -1:
+        return a & MASK64
+    return div_trunc(a, b) & MASK64
+
+
+def alu_rem(a, b):
+    a, b = s64(a), s64(b)
+    if b == 0:
+        return a & MASK64
+    if a == -(1 << 63) and b == -1:
+        return 0
+    return (a - div_trunc(a, b) * b) & MASK64
+
+
+def alu_divw(a, b):
+    a, b = sx(a, 32), sx(b, 32)
+    if b == 0:
+        return MASK64
+    if a == -(1 << 31) and b == -1:
+        return sx32(a)
+    return sx32(div_trunc(a, b))
+
+
+def alu_remw(a, b):
+    a, b = sx(a, 32), sx(b, 32)
+    if b == 0:
+        return sx32(a)
+    if a == -(1 << 31) and b == -1:
+        return 0
+    return sx32(a - div_trunc(a, b) * b)
+
+
+OP_RR = {
+    (0x00, 0): lambda a, b: (a + b) & MASK64,
+    (0x20, 0): lambda a, b: (a - b) & MASK64,
+    (0x00, 1): lambda a, b: (a << (b & 63)) & MASK64,
+    (0x00, 2): lambda a, b: int(s64(a) < s64(b)),
+    (0x00, 3): lambda a, b: int(a < b),
+    (0x00, 4): lambda a, b: a ^ b,
+    (0x00, 5): lambda a, b: a >> (b & 63),
+    (0x20, 5): lambda a, b: (s64(a) >> (b & 63)) & MASK64,
+    (0x00, 6): lambda a, b: a | b,
+    (0x00, 7): lambda a, b: a & b,
+    (0x01, 0): lambda a, b: (a * b) & MASK64,
+    (0x01, 1): lambda a, b: ((s64(a) * s64(b)) >> 64) & MASK64,
+    (0x01, 2): lambda a, b: ((s64(a) * b) >> 64) & MASK64,
+    (0x01, 3): lambda a, b: (a * b) >> 64,
+    (0x01, 4): alu_div,
+    (0x01, 5): lambda a, b: a // b if b else MASK64,
+    (0x01, 6): alu_rem,
+    (0x01, 7): lambda a, b: a % b if b else a,
+}
+
+OP_RR32 = {
+    (0x00, 0): lambda a, b: sx32(a + b),
+    (0x20, 0): lambda a, b: sx32(a - b),
+    (0x00, 1): lambda a, b: sx32(a << (b & 31)),
+    (0x00, 5): lambda a, b: sx32((a & 0xffffffff) >> (b & 31)),
+    (0x20, 5): lambda a, b: sx32(sx(a, 32) >> (b & 31)),
+    (0x01, 0): lambda a, b: sx32(a * b),
+    (0x01, 4): alu_divw,
+    (0x01, 5): lambda a, b: sx32((a & 0xffffffff) // (b & 0xffffffff)) if b & 0xffffffff else MASK64,
+    (0x01, 6): alu_remw,
+    (0x01, 7): lambda a, b: sx32((a & 0xffffffff) % (b & 0xffffffff)) if b & 0xffffffff else sx32(a),
+}
+
+BRANCH = {
+    0: lambda a, b: a == b,
+    1: lambda a, b: a != b,
+    4: lambda a, b: s64(a) < s64(b),
+    5: lambda a, b: s64(a) >= s64(b),
+    6: lambda a, b: a < b,
+    7: lambda a, b: a >= b,
+}
+
+# A 扩展 AMO：funct5 -> op(旧值, rs2, 位宽)，操作数已截成位宽
+AMO_OPS = {
+    0x00: lambda a, b, bits: a + b,
+    0x01: lambda a, b, bits: b,
+    0x04: lambda a, b, bits: a ^ b,
+    0x08: lambda a, b, bits: a | b,
+    0x0C: lambda a, b, bits: a & b,
+    0x10: lambda a, b, bits: a if sx(a, bits) < sx(b, bits) else b,
+    0x14: lambda a, b, bits: a if sx(a, bits) > sx(b, bits) else b,
+    0x18: lambda a, b, bits: min(a, b),
+    0x1C: lambda a, b, bits: max(a, b),
+}
+
+# 位操作扩展（--ext），默认不启用，对应指令为非法指令
+def clmul(a, b):
+    r = 0
+    while b:
+        if b & 1:
+            r ^= a
+        a <<= 1
+        b >>= 1
+    return r
+
+
+def ctz(a, bits):
+    return (a & -a).bit_length() - 1 if a & ((1 << bits) - 1) else bits
+
+
+def rotr(a, n, bits):
+    mask = (1 << bits) - 1
+    a &= mask
+    n %= bits
+    return ((a >> n) | (a << (bits - n))) & mask
+
+
+def orc_b(a):
+    return int.from_bytes(bytes(0xff if b else 0 for b in a.to_bytes(8, 'little')), 'little')
+
+
+# 扩展名 -> {(funct7, funct3): op}，R 型（OP / OP-32）
+EXT_RR = {
+    'zba': {(0x10, 2): lambda a, b: ((a << 1) + b) & MASK64,
+            (0x10, 4): lambda a, b: ((a << 2) + b) & MASK64,
+            (0x10, 6): lambda a, b: ((a << 3) + b) & MASK64},
+    'zbb': {(0x20, 7): lambda a, b: a & ~b & MASK64,
+            (0x20, 6): lambda a, b: (a | ~b) & MASK64,
+            (0x20, 4): lambda a, b: ~(a ^ b) & MASK64,
+            (0x05, 4): lambda a, b: a if s64(a) < s64(b) else b,
+            (0x05, 5): min,
+            (0x05, 6): lambda a, b: a if s64(a) > s64(b) else b,
+            (0x05, 7): max,
+            (0x30, 1): lambda a, b: rotr(a, -b & 63, 64),
+            (0x30, 5): lambda a, b: rotr(a, b & 63, 64)},
+    'zbc': {(0x05, 1): lambda a, b: clmul(a, b) & MASK64,
+            (0x05, 3): lambda a, b: clmul(a, b) >> 64,
+            (0x05, 2): lambda a, b: (clmul(a, b) >> 63) & MASK64},
+    'zbs': {(0x24, 1): lambda a, b: a & ~(1 << (b & 63)),
+            (0x24, 5): lambda a, b: (a >> (b & 63)) & 1,
+            (0x34, 1): lambda a, b: a ^ (1 << (b & 63)),
+            (0x14, 1): lambda a, b: a | (1 << (b & 63))},
+}
+
+EXT_RR32 = {
+    'zba': {(0x04, 0): lambda a, b: ((a & 0xffffffff) + b) & MASK64,
+            (0x10, 2): lambda a, b: (((a & 0xffffffff) << 1) + b) & MASK64,
+            (0x10, 4): lambda a, b: (((a & 0xffffffff) << 2) + b) & MASK64,
+            (0x10, 6): lambda a, b: (((a & 0xffffffff) << 3) + b) & MASK64},
+    'zbb': {(0x30, 1): lambda a, b: sx32(rotr(a, -b & 31, 32)),
+            (0x30, 5): lambda a, b: sx32(rotr(a, b & 31, 32)),
+            (0x04, 4): lambda a, b: a & 0xffff},        # zext.h（rs2 = 0）
+}
+
+# 扩展名 -> {(opcode, funct3, imm[11:0]): op}，单操作数指令
+EXT_UNARY = {
+    'zbb': {(0x13, 1, 0x600): lambda a: 64 - a.bit_length(),
+            (0x13, 1, 0x601): lambda a: ctz(a, 64),
+            (0x13, 1, 0x602): lambda a: bin(a).count('1'),
+            (0x13, 1, 0x604): lambda a: sx(a, 8) & MASK64,
+            (0x13, 1, 0x605): lambda a: sx(a, 16) & MASK64,
+            (0x13, 5, 0x287): orc_b,
+            (0x13, 5, 0x6b8): lambda a: int.from_bytes(a.to_bytes(8, 'little'), 'big'),
+            (0x1b, 1, 0x600): lambda a: 32 - (a & 0xffffffff).bit_length(),
+            (0x1b, 1, 0x601): lambda a: ctz(a, 32),
+            (0x1b, 1, 0x602): lambda a: bin(a & 0xffffffff).count('1')},
+}
+
+# 扩展名 -> {(opcode, funct3, imm[11:6]): op(rs1, shamt)}，立即数移位类指令
+EXT_SHIFT_IMM = {
+    'zba': {(0x1b, 1, 0x02): lambda a, n: ((a & 0xffffffff) << n) & MASK64},
+    'zbb': {(0x13, 5, 0x18): lambda a, n: rotr(a, n, 64),
+            (0x1b, 5, 0x18): lambda a, n: sx32(rotr(a, n & 31, 32))},
+    'zbs': {(0x13, 1, 0x12): lambda a, n: a & ~(1 << n),
+            (0x13, 1, 0x1a): lambda a, n: a ^ (1 << n),
+            (0x13, 1, 0x0a): lambda a, n: a | (1 << n),
+            (0x13, 5, 0x12): lambda a, n: (a >> n) & 1},
+}
+
+EXTENSIONS = ('zba', 'zbb', 'zbc', 'zbs')
+
+
+LOADS = {0: (1, True), 1: (2, True), 2: (4, True), 3: (8, False), 4: (1, False), 5: (2, False), 6: (4, False)}
+
+
+def decode(m, inst):
+    x = m.x
+    opcode = inst & 0x7f
+    rd = (inst >> 7) & 0x1f
+    f3 = (inst >> 12) & 7
+    rs1 = (inst >> 15) & 0x1f
+    rs2 = (inst >> 20) & 0x1f
+    f7 = inst >> 25
+    imm_i = sx(inst >> 20, 12)
+    # 写 x0 的结果落到不会被读取的 x[32]
+    rdw = rd if rd else 32
+
+    def illegal(pc):
+        raise Trap(CAUSE_ILLEGAL, inst)
+
+    if opcode == 0x37:      # LUI
+        value = sx(inst & 0xfffff000, 32) & MASK64
+
+        def f(pc):
+            x[rdw] = value
+            return pc + 4
+        return f
+
+    if opcode == 0x17:      # AUIPC
+        offset = sx(inst & 0xfffff000, 32)
+
+        def f(pc):
+            x[rdw] = (pc + offset) & MASK64
+            return pc + 4
+        return f
+
+    if opcode == 0x6f:      # JAL
+        offset = sx(((inst >> 31) << 20) | (((inst >> 12) & 0xff) << 12) |
+                    (((inst >> 20) & 1) << 11) | (((inst >> 21) & 0x3ff) << 1), 21)
+        if offset == 0:
+            def f(pc):
+                raise Halt(pc)
+            return f
+
+        def f(pc):
+            x[rdw] = pc + 4
+            return (pc + offset) & MASK64
+        return f
+
+    if opcode == 0x67:      # JALR
+        def f(pc):
+            target = (x[rs1] + imm_i) & ~1 & MASK64
+            x[rdw] = pc + 4
+            return target
+        return f
+
+    if opcode == 0x63:      # BRANCH
+        cond = BRANCH.get(f3)
+        if cond is None:
+            return illegal
+        offset = sx(((inst >> 31) << 12) | (((inst >> 7) & 1) << 11) |
+                    (((inst >> 25) & 0x3f) << 5) | (((inst >> 8) & 0xf) << 1), 13)
+
+        def f(pc):
+            return (pc + offset) & MASK64 if cond(x[rs1], x[rs2]) else pc + 4
+        return f
+
+    if opcode == 0x03:      # LOAD
+        if f3 not in LOADS:
+            return illegal
+        size, signed = LOADS[f3]
+        load = m.load
+
+        def f(pc):
+            value = load((x[rs1] + imm_i) & MASK64, size)
+            if signed:
+                value = sx(value, size * 8) & MASK64
+            x[rdw] = value
+            return pc + 4
+        return f
+
+    if opcode == 0x23:      # STORE
+        if f3 > 3:
+            return illegal
+        size = 1 << f3
+        imm_s = sx(((inst >> 25) << 5) | ((inst >> 7) & 0x1f), 12)
+        store = m.store
+
+        def f(pc):
+            store((x[rs1] + imm_s) & MASK64, size, x[rs2])
+            return pc + 4
+        return f
+
+    if opcode in (0x13, 0x1b) and (opcode, f3, inst >> 20) in m.ext_unary:     # Zbb 单操作数
+        op = m.ext_unary[(opcode, f3, inst >> 20)]
+
+        def f(pc):
+            x[rdw] = op(x[rs1])
+            return pc + 4
+        return f
+
+    if opcode in (0x13, 0x1b) and f3 in (1, 5) and (opcode, f3, inst >> 26) in m.ext_shift_imm:
+        op = m.ext_shift_imm[(opcode, f3, inst >> 26)]
+        shamt = (inst >> 20) & 0x3f
+
+        def f(pc):
+            x[rdw] = op(x[rs1], shamt)
+            return pc + 4
+        return f
+
+    if opcode == 0x13:      # OP-IMM
+        shamt = (inst >> 20) & 0x3f
+        if f3 == 1:
+            if inst >> 26:
+                return illegal
+            op = OP_RR[(0, 1)]
+            imm = shamt
+        elif f3 == 5:
+            if inst >> 26 not in (0x00, 0x10):
+                return illegal
+            op = OP_RR[((inst >> 25) & 0x20, 5)]
+            imm = shamt
+        else:
+            op = OP_RR[(0, f3)]
+            imm = imm_i & MASK64
+
+        def f(pc):
+            x[rdw] = op(x[rs1], imm)
+            return pc + 4
+        return f
+
+    if opcode == 0x1b:      # OP-IMM-32
+        shamt = (inst >> 20) & 0x1f
+        if f3 == 0:
+            def f(pc):
+                x[rdw] = sx32(x[rs1] + imm_i)
+                return pc + 4
+            return f
+        key = (f7, f3)
+        if key not in ((0x00, 1), (0x00, 5), (0x20, 5)):
+            return illegal
+        op = OP_RR32[key]
+
+        def f(pc):
+            x[rdw] = op(x[rs1], shamt)
+            return pc + 4
+        return f
+
+    if opcode in (0x33, 0x3b):      # OP / OP-32
+        table = OP_RR if opcode == 0x33 else OP_RR32
+        op = table.get((f7, f3)) or (m.ext_rr if opcode == 0x33 else m.ext_rr32).get((f7, f3))
+        if op is None:
+            return illegal
+
+        def f(pc):
+            x[rdw] = op(x[rs1], x[rs2])
+            return pc + 4
+        return f
+
+    if opcode == 0x2f:      # A 扩展（LR/SC/AMO）
+        if f3 not in (2, 3):
+            return illegal
+        size = 4 if f3 == 2 else 8
+        bits = size * 8
+        mask = (1 << bits) - 1
+        ext = sx32 if size == 4 else (lambda v: v)
+        funct5 = inst >> 27
+        load, store = m.load, m.store
+
+        if funct5 == 0x02:      # LR
+            def f(pc):
+                addr = x[rs1]
+                if addr & (size - 1):
+                    raise Trap(CAUSE_LOAD_MISALIGNED, addr)
+                value = load(addr, size)
+                m.reservation = (addr, size, value)
+                x[rdw] = ext(value)
+                return pc + 4
+            return f
+
+        if funct5 == 0x03:      # SC
+            # 保留只记录地址和读到的值：其它 hart 在此期间写回相同的值时 SC 仍会成功
+            def f(pc):
+                addr = x[rs1]
+                if addr & (size - 1):
+                    raise Trap(CAUSE_STORE_MISALIGNED, addr)
+                reservation, m.reservation = m.reservation, None
+                if reservation == (addr, size, load(addr, size)):
+                    store(addr, size, x[rs2])
+                    x[rdw] = 0
+                else:
+                    x[rdw] = 1
+                return pc + 4
+            return f
+
+        op = AMO_OPS.get(funct5)
+        if op is None:
+            return illegal
+
+        def f(pc):
+            addr = x[rs1]
+            if addr & (size - 1):
+                raise Trap(CAUSE_STORE_MISALIGNED, addr)
+            old = load(addr, size)
+            store(addr, size, op(old, x[rs2] & mask, bits) & mask)
+            x[rdw] = ext(old)
+            return pc + 4
+        return f
+
+    if opcode == 0x0f:      # FENCE / FENCE.I
+        if f3 == 1:
+            def f(pc):
+                m.icache.clear()
+                return pc + 4
+            return f
+        return lambda pc: pc + 4
+
+    if opcode == 0x73:      # SYSTEM
+        if f3 == 0:
+            if inst == 0x00000073:
+                def f(pc):
+                    raise Trap(CAUSE_ECALL_M)
+                return f
+            if inst == 0x00100073:
+                return m.ebreak
+            if inst == 0x30200073:
+                return m.mret
+            if inst == 0x10500073:
+                return m.wfi
+            if (inst & 0xfe007fff) == 0x12000073:      # SFENCE.VMA
+                return lambda pc: pc + 4
+            return illegal
+        csr = inst >> 20
+        use_imm = f3 & 4
+        kind = f3 & 3
+
+        def f(pc):
+            src = rs1 if use_imm else x[rs1]
+            old = m.read_csr(csr)
+            if kind == 1:
+                m.write_csr(csr, src)
+            elif rs1 != 0:
+                m.write_csr(csr, old | src if kind == 2 else old & ~src)
+            x[rdw] = old
+            return pc + 4
+        return f
+
+    return illegal
+
+
+##################################################################################
+# 处理器与系统
+##################################################################################
+
+class Machine:
+    def __init__(self, args, boot=None, hartid=0):
+        self.cpu_freq = args.cpu_freq
+        self.hartid = hartid
+        self.x = [0] * 33
+        self.pc = 0
+        self.cycle = 0
+        self.instret = 0
+        self.csr = {CSR_MSTATUS: 0, CSR_MIE: 0, CSR_MTVEC: 0, CSR_MEPC: 0,
+                    CSR_MCAUSE: 0, CSR_MTVAL: 0}
+        # MXL=64, I + M + A；--ext 同时有 Zba/Zbb/Zbs 时置 B 位
+        self.misa = (2 << 62) | (1 << 8) | (1 << 12) | (1 << 0)
+        ext = set(args.ext)
+        if {'zba', 'zbb', 'zbs'} <= ext:
+            self.misa |= 1 << 1
+        self.ext_rr = {k: v for e in ext for k, v in EXT_RR.get(e, {}).items()}
+        self.ext_rr32 = {k: v for e in ext for k, v in EXT_RR32.get(e, {}).items()}
+        self.ext_unary = {k: v for e in ext for k, v in EXT_UNARY.get(e, {}).items()}
+        self.ext_shift_imm = {k: v for e in ext for k, v in EXT_SHIFT_IMM.get(e, {}).items()}
+        self.icache = {}
+        self.next_check = 0
+        self.warned_csr = set()
+        self.reservation = None     # LR 的 (地址, 位宽, 值)
+        self.halted = False
+
+        if boot is not None:
+            # 其余 hart 共享内存和外设，只有寄存器、CSR 和译码缓存是自己的
+            self.ram, self.ram_end, self.regions = boot.ram, boot.ram_end, boot.regions
+            self.uart, self.clint, self.devices = boot.uart, boot.clint, boot.devices
+            self.clint.add_hart(self)
+            return
+
+        self.ram = bytearray(args.ram_size)
+        self.ram_end = RAM_BASE + args.ram_size
+        self.regions = [
+            (SPM_BASE, bytearray(args.spm_size)),
+            (PSRAM_BASE, bytearray(args.psram_size)),
+        ]
+        self.uart = Uart16550(self, not args.no_baud, not args.quiet, not args.exact_poll, args.rx_fifo)
+        self.clint = Clint(self, args.mtime_freq)
+        self.devices = [
+            (UART_BASE, 0x1000, self.uart),
+            (CLINT_BASE, 0x10000, self.clint),
+            (DRAMCTL_BASE, 0x1000, Scratch(0x1000)),
+        ]
+
+    # ---------------------------------------------------------------- 内存
+    def find(self, addr, size):
+        for base, mem in self.regions:
+            off = addr - base
+            if 0 <= off and off + size <= len(mem):
+                return mem, off
+        return None, 0
+
+    def load(self, addr, size):
+        off = addr - RAM_BASE
+        if 0 <= off and addr + size <= self.ram_end:
+            return int.from_bytes(self.ram[off:off + size], 'little')
+        mem, off = self.find(addr, size)
+        if mem is not None:
+            return int.from_bytes(mem[off:off + size], 'little')
+        for base, length, dev in self.devices:
+            if base <= addr < base + length:
+                return dev.read(addr - base, size) & ((1 << (size * 8)) - 1)
+        raise Trap(CAUSE_LOAD_FAULT, addr)
+
+    def store(self, addr, size, value):
+        value &= (1 << (size * 8)) - 1
+        off = addr - RAM_BASE
+        if 0 <= off and addr + size <= self.ram_end:
+            self.ram[off:off + size] = value.to_bytes(size, 'little')
+            # 自修改代码（如解压到内存后跳转）需要作废已译码的指令
+            if self.icache:
+                self.icache.pop(addr & ~3, None)
+                self.icache.pop((addr + size - 1) & ~3, None)
+            return
+        mem, off = self.find(addr, size)
+        if mem is not None:
+            mem[off:off + size] = value.to_bytes(size, 'little')
+            return
+        for base, length, dev in self.devices:
+            if base <= addr < base + length:
+                dev.write(addr - base, size, value)
+                return
+        raise Trap(CAUSE_STORE_FAULT, addr)
+
+    def load_image(self, addr, data):
+        for i in range(0, len(data), 4096):
+            chunk = data[i:i + 4096]
+            a = addr + i
+            off = a - RAM_BASE
+            if 0 <= off and a + len(chunk) <= self.ram_end:
+                self.ram[off:off + len(chunk)] = chunk
+                continue
+            mem, off = self.find(a, len(chunk))
+            if mem is None:
+                raise ValueError(f'segment at 0x{a:x} is outside simulated memory')
+            mem[off:off + len(chunk)] = chunk
+
+    # ---------------------------------------------------------------- CSR
+    def mip(self):
+        mip = 0
+        if self.clint.msip[self.hartid]:
+            mip |= MIP_MSIP
+        if self.clint.mtime() >= self.clint.mtimecmp[self.hartid]:
+            mip |= MIP_MTIP
+        return mip
+
+    def read_csr(self, csr):
+        if csr in (CSR_MCYCLE, CSR_CYCLE):
+            return self.cycle & MASK64
+        if csr in (CSR_MINSTRET, CSR_INSTRET):
+            return self.instret & MASK64
+        if csr == CSR_TIME:
+            return self.clint.mtime()
+        if csr == CSR_MIP:
+            return self.mip()
+        if csr == CSR_MISA:
+            return self.misa
+        if csr == CSR_MHARTID:
+            return self.hartid
+        if csr not in self.csr and csr not in self.warned_csr:
+            self.warned_csr.add(csr)
+        return self.csr.get(csr, 0)
+
+    def write_csr(self, csr, value):
+        if csr in (CSR_MCYCLE, CSR_MINSTRET, CSR_MIP, CSR_MISA, CSR_MHARTID, CSR_CYCLE, CSR_TIME, CSR_INSTRET):
+            return
+        self.csr[csr] = value & MASK64
+        if csr in (CSR_MSTATUS, CSR_MIE):
+            self.schedule_irq_check()
+
+    # ---------------------------------------------------------------- 异常与中断
+    def schedule_irq_check(self):
+        self.next_check = self.instret
+
+    def take_trap(self, pc, cause, tval, interrupt):
+        self.csr[CSR_MEPC] = pc
+        self.csr[CSR_MCAUSE] = cause | (SIGN64 if interrupt else 0)
+        self.csr[CSR_MTVAL] = tval & MASK64
+        mstatus = self.csr[CSR_MSTATUS]
+        mpie = MSTATUS_MPIE if mstatus & MSTATUS_MIE else 0
+        self.csr[CSR_MSTATUS] = (mstatus & ~(MSTATUS_MIE | MSTATUS_MPIE)) | mpie | MSTATUS_MPP
+        mtvec = self.csr[CSR_MTVEC]
+        base = mtvec & ~3
+        if interrupt and (mtvec & 3) == 1:
+            return base + 4 * cause
+        return base
+
+    def pending_irq(self):
+        if not (self.csr[CSR_MSTATUS] & MSTATUS_MIE):
+            return None
+        pending = self.mip() & self.csr[CSR_MIE]
+        for cause in (11, 3, 7):
+            if pending & (1 << cause):
+                return cause
+        return None
+
+    def mret(self, pc):
+        mstatus = self.csr[CSR_MSTATUS]
+        mie = MSTATUS_MIE if mstatus & MSTATUS_MPIE else 0
+        self.csr[CSR_MSTATUS] = (mstatus & ~MSTATUS_MIE) | mie | MSTATUS_MPIE
+        self.schedule_irq_check()
+        return self.csr[CSR_MEPC]
+
+    def wfi(self, pc):
+        # 没有可唤醒的中断时，把时间快进到 mtimecmp
+        if not (self.mip() & self.csr[CSR_MIE]):
+            mtimecmp = self.clint.mtimecmp[self.hartid]
+            if self.csr[CSR_MIE] & MIP_MTIP and mtimecmp != MASK64:
+                target = self.clint.cycle_for_mtime(mtimecmp)
+                if target > self.cycle:
+                    self.cycle = target
+        self.schedule_irq_check()
+        return pc + 4
+
+    def ebreak(self, pc):
+        # RISC-V 半主机：ebreak 前后为 slli x0,x0,0x1f 与 srai x0,x0,7（src/console.h CONSOLE_SEMIHOST）
+        try:
+            semihost = self.load(pc - 4, 4) == SEMIHOST_PRE and self.load(pc + 4, 4) == SEMIHOST_POST
+        except Trap:
+            semihost = False
+        if not semihost:
+            raise Trap(CAUSE_BREAKPOINT, pc)
+        self.x[10] = self.semihost(self.x[10], self.x[11]) & MASK64
+        return pc + 4
+
+    def semihost(self, op, arg):
+        if op == SYS_WRITEC:
+            self.uart.emit(self.load(arg, 1))
+            return 0
+        if op == SYS_WRITE0:
+            while True:
+                c = self.load(arg, 1)
+                if c == 0:
+                    return 0
+                self.uart.emit(c)
+                arg += 1
+        if op == SYS_WRITE:
+            # 参数块 {fd, buf, len}，返回未写出的字节数
+            buf, length = self.load(arg + 8, 8), self.load(arg + 16, 8)
+            for i in range(length):
+                self.uart.emit(self.load(buf + i, 1))
+            return 0
+        if op == SYS_READC:
+            # 与真实调试器不同，没有输入时不阻塞而是返回 -1
+            if self.uart.rx_ready():
+                self.uart.bytes_in += 1
+                return self.uart.rx.popleft()[1]
+            return -1
+        return -1
+
+    def timer_check_cycle(self):
+        mtimecmp = self.clint.mtimecmp[self.hartid]
+        if mtimecmp == MASK64 or not (self.csr[CSR_MIE] & MIP_MTIP):
+            return None
+        return self.clint.cycle_for_mtime(mtimecmp)
+
+    # ---------------------------------------------------------------- 执行
+    def run(self, max_insns, poll, poll_interval=256):
+        x = self.x
+        icache = self.icache
+        load = self.load
+        pc = self.pc
+        halted_at = None
+        while True:
+            try:
+                while True:
+                    f = icache.get(pc)
+                    if f is None:
+                        if pc & 3:
+                            raise Trap(0, pc)
+                        f = decode(self, load(pc, 4))
+                        icache[pc] = f
+                    pc = f(pc)
+                    self.instret += 1
+                    self.cycle += 1
+                    if self.instret >= self.next_check:
+                        break
+            except Trap as t:
+                pc = self.take_trap(pc, t.cause, t.tval, False)
+                self.instret += 1
+                self.cycle += 1
+            except Halt as h:
+                halted_at = h.args[0]
+                break
+
+            x[32] = 0
+            cause = self.pending_irq()
+            if cause is not None:
+                pc = self.take_trap(pc, cause, 0, True)
+            if self.instret >= max_insns:
+                break
+            if not poll():
+                break
+            self.next_check = self.instret + poll_interval
+            timer = self.timer_check_cycle()
+            if timer is not None and timer > self.cycle:
+                self.next_check = min(self.next_check, self.instret + (timer - self.cycle))
+            elif timer is not None:
+                self.next_check = self.instret + 1
+        self.pc = pc
+        return halted_at
+
+    def select(self):
+        """让共享外设（UART 时间、mtime）以本 hart 的周期计时"""
+        self.uart.m = self
+        self.clint.m = self
+
+
+def run_harts(harts, max_insns, poll, quantum):
+    """
+    轮流让每个 hart 执行约 quantum 条指令。hart 0 停机或用完指令预算时结束；
+    落后于 hart 0 的 hart 先把周期追到 hart 0（如 hart 0 在 UART 忙等中快进了时间）
+    """
+    boot = harts[0]
+    while True:
+        for h in harts[1:]:
+            if h.halted:
+                continue
+            h.cycle = max(h.cycle, boot.cycle)
+            h.select()
+            if h.run(h.instret + quantum, lambda: True, quantum) is not None:
+                h.halted = True
+        boot.select()
+        halted_at = boot.run(min(max_insns, boot.instret + quantum), poll, quantum)
+        if halted_at is not None or boot.instret >= max_insns:
+            return halted_at
+
+
+##################################################################################
+# 输入脚本
+##################################################################################
+
+def unescape(text):
+    return codecs.escape_decode(text.encode('utf-8'))[0]
+
+
+class Script:
+    """
+    每行一条命令：
+      expect <text>    等待UART输出包含text（从上一次匹配处开始）
+      send <text>      向UART输入text（支持 \\n、\\x41 等转义）
+      sendline <text>  输入 text + '\\n'
+      wait <us>        等待指定的模拟时间后再继续
+    """
+
+    def __init__(self, path):
+        self.cmds = []
+        self.path = path
+        with open(path) as f:
+            for lineno, line in enumerate(f, 1):
+                line = line.rstrip('\n')
+                if not line.strip() or line.lstrip().startswith('#'):
+                    continue
+                cmd, _, arg = line.partition(' ')
+                if cmd not in ('expect', 'send', 'sendline', 'wait'):
+                    raise ValueError(f'{path}:{lineno}: unknown command {cmd!r}')
+                self.cmds.append((lineno, cmd, arg))
+        self.index = 0
+        self.mark = 0
+        self.wait_until = None
+
+    def done(self):
+        return self.index >= len(self.cmds)
+
+    def current(self):
+        return self.cmds[self.index] if not self.done() else None
+
+    def poll(self, m):
+        while not self.done():
+            lineno, cmd, arg = self.cmds[self.index]
+            if cmd == 'expect':
+                needle = unescape(arg)
+                pos = m.uart.output.find(needle, self.mark)
+                if pos < 0:
+                    return
+                self.mark = pos + len(needle)
+            elif cmd == 'send':
+                m.uart.feed(unescape(arg))
+            elif cmd == 'sendline':
+                m.uart.feed(unescape(arg) + b'\n')
+            elif cmd == 'wait':
+                if self.wait_until is None:
+                    self.wait_until = m.cycle + int(arg) * m.cpu_freq // 1000000
+                if m.cycle < self.wait_until:
+                    return
+                self.wait_until = None
+            self.index += 1
+
+
+##################################################################################
+# 主程序
+##################################################################################
+
+TEST_MARKER = re.compile(rb'=== (.+?) ===')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Run a bare-metal RV64IMA ELF on a minimal virtual platform')
+    parser.add_argument('elf', help='program to run, e.g. bin/main.elf')
+    parser.add_argument('--script', help='UART input/expect script')
+    parser.add_argument('--report', help='write run statistics to this JSON file')
+    parser.add_argument('--cpu-freq', type=int, default=115000000, help='core and UART clock in Hz (PLAT_CLK_FREQ)')
+    parser.add_argument('--mtime-freq', type=int, default=1000000, help='CLINT mtime frequency (TIMER_MTIME_FREQ)')
+    parser.add_argument('--ram-size', type=lambda v: int(v, 0), default=16 << 20, help='main RAM size at 0x80000000')
+    parser.add_argument('--spm-size', type=lambda v: int(v, 0), default=1 << 20, help='scratchpad size at 0x30000000')
+    parser.add_argument('--psram-size', type=lambda v: int(v, 0), default=16 << 20, help='PSRAM size at 0xa0000000')
+    parser.add_argument('--max-insns', type=int, default=500_000_000, help='instruction budget')
+    parser.add_argument('--no-baud', action='store_true', help='do not model UART baud-rate timing')
+    parser.add_argument('--exact-poll', action='store_true',
+                        help='simulate every UART status poll instead of skipping ahead to THRE')
+    parser.add_argument('--rx-fifo', type=int, default=0,
+                        help='16550 receive FIFO depth; input arriving while it is full is dropped with LSR.OE (0: unlimited)')
+    parser.add_argument('--quiet', action='store_true', help='do not echo UART output')
+    parser.add_argument('--uart-log', help='write the raw UART output to this file')
+    parser.add_argument('--symbols', help='ELF to take symbols from, e.g. bin/main.elf when running bin/main.lz4.elf')
+    parser.add_argument('--harts', type=int, default=1, help='number of harts (mhartid 0..N-1), all start at the entry point')
+    parser.add_argument('--quantum', type=int, default=64, help='instructions each hart runs before switching (--harts > 1)')
+    parser.add_argument('--ext', type=lambda v: [e for e in v.lower().split(',') if e], default=[],
+                        help=f'extra extensions, comma separated ({", ".join(EXTENSIONS)}); others are illegal instructions')
+
+    args = parser.parse_args()
+    for e in args.ext:
+        if e not in EXTENSIONS:
+            parser.error(f'unknown extension {e!r}, expected one of {", ".join(EXTENSIONS)}')
+
+    entry, segments, symbols = load_elf(args.elf)
+    if args.symbols:
+        symbols = load_elf(args.symbols)[2]
+    m = Machine(args)
+    for addr, data in segments:
+        m.load_image(addr, data)
+    m.pc = entry
+    harts = [m]
+    for hartid in range(1, args.harts):
+        hart = Machine(args, m, hartid)
+        hart.pc = entry
+        harts.append(hart)
+
+    script = Script(args.script) if args.script else None
+    tests = []
+
+    def on_line(line):
+        match = TEST_MARKER.search(line)
+        if match:
+            tests.append({'name': match.group(1).decode(errors='replace'),
+                          'cycle': m.cycle, 'instret': m.instret})
+
+    m.uart.on_line = on_line
+
+    def poll():
+        if script:
+            script.poll(m)
+        return True
+
+    start = time.time()
+    if len(harts) > 1:
+        halted_at = run_harts(harts, args.max_insns, poll, args.quantum)
+    else:
+        halted_at = m.run(args.max_insns, poll)
+    if script:
+        script.poll(m)
+    elapsed = time.time() - start
+    sys.stdout.flush()
+
+    ok = True
+    if halted_at is None:
+        status = f'instruction budget exhausted at pc 0x{m.pc:x}'
+        ok = False
+    elif halted_at == symbols.get('loop'):
+        status = 'program finished'
+    else:
+        name = next((n for n, v in symbols.items() if v == halted_at), None)
+        status = f'hart parked at 0x{halted_at:x}' + (f' <{name}>' if name else '')
+        ok = False
+
+    if script and not script.done():
+        lineno, cmd, arg = script.current()
+        print(f'[rvsim] FAIL: {script.path}:{lineno}: {cmd} {arg!r} not satisfied', file=sys.stderr)
+        ok = False
+
+    for i, t in enumerate(tests):
+        end = tests[i + 1] if i + 1 < len(tests) else {'cycle': m.cycle, 'instret': m.instret}
+        t['cycles'] = end['cycle'] - t['cycle']
+        t['instructions'] = end['instret'] - t['instret']
+
+    sim_seconds = m.cycle / m.cpu_freq
+    out_bytes = len(m.uart.output)
+    report = {
+        'elf': args.elf,
+        'status': status,
+        'passed': ok,
+        'instructions': m.instret,
+        'cycles': m.cycle,
+        'sim_seconds': sim_seconds,
+        'uart_bytes_out': out_bytes,
+        'uart_bytes_in': m.uart.bytes_in,
+        'uart_rx_overruns': m.uart.overruns,
+        'uart_bytes_per_second': out_bytes / sim_seconds if sim_seconds else 0,
+        'host_seconds': elapsed,
+        'host_insns_per_second': m.instret / elapsed if elapsed else 0,
+        'tests': tests,
+    }
+
+    err = sys.stderr
+    print(f'\n[rvsim] {status}: {m.instret} instructions, {m.cycle} cycles '
+          f'({sim_seconds * 1000:.3f} ms @ {m.cpu_freq / 1e6:g} MHz)', file=err)
+    print(f'[rvsim] UART: {out_bytes} bytes out ({report["uart_bytes_per_second"]:.0f} B/s), '
+          f'{m.uart.bytes_in} bytes in; host {report["host_insns_per_second"] / 1e6:.2f} MIPS', file=err)
+    for t in tests:
+        print(f'[rvsim]   {t["name"]:<40} {t["cycles"]:>12} cycles', file=err)
+
+    if args.report:
+        with open(args.report, 'w') as f:
+            json.dump(report, f, indent=2)
+    if args.uart_log:
+        with open(args.uart_log, 'wb') as f:
+            f.write(m.uart.output)
+
+    sys.exit(0 if ok else 1)
+
+
+if __name__ == '__main__':
+    main()